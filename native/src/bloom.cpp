@@ -0,0 +1,205 @@
+#include "bloom.hpp"
+
+#include <rlgl.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace {
+// Smallest level side; halving further only blurs a few pixels.
+constexpr int MIN_LEVEL_SIZE = 4;
+
+// Five taps: the centre and the four diagonals one source texel out, which
+// bilinear filtering turns into a 16-texel footprint. With threshold.z set it
+// also keeps only what is brighter than threshold.x, over a soft knee of
+// threshold.y.
+constexpr const char* DOWN_SHADER = R"(#version 330
+in vec2 fragTexCoord;
+uniform sampler2D texture0;
+uniform vec2 texel;
+uniform vec3 threshold;
+out vec4 finalColor;
+void main() {
+    vec3 sum = texture(texture0, fragTexCoord).rgb * 4.0;
+    sum += texture(texture0, fragTexCoord + vec2(-texel.x, -texel.y)).rgb;
+    sum += texture(texture0, fragTexCoord + vec2(texel.x, -texel.y)).rgb;
+    sum += texture(texture0, fragTexCoord + vec2(-texel.x, texel.y)).rgb;
+    sum += texture(texture0, fragTexCoord + vec2(texel.x, texel.y)).rgb;
+    vec3 color = sum / 8.0;
+    if (threshold.z > 0.0) {
+        float brightness = max(color.r, max(color.g, color.b));
+        float soft = clamp(brightness - threshold.x + threshold.y, 0.0, 2.0 * threshold.y);
+        soft = soft * soft / (4.0 * threshold.y + 1e-4);
+        color *= max(soft, brightness - threshold.x) / max(brightness, 1e-4);
+    }
+    finalColor = vec4(color, 1.0);
+}
+)";
+
+// Eight taps: four along the axes one source texel out and four diagonals
+// half a texel out, weighted 1 and 2.
+constexpr const char* UP_SHADER = R"(#version 330
+in vec2 fragTexCoord;
+uniform sampler2D texture0;
+uniform vec2 texel;
+out vec4 finalColor;
+void main() {
+    vec2 h = texel * 0.5;
+    vec3 sum = texture(texture0, fragTexCoord + vec2(-texel.x, 0.0)).rgb;
+    sum += texture(texture0, fragTexCoord + vec2(texel.x, 0.0)).rgb;
+    sum += texture(texture0, fragTexCoord + vec2(0.0, -texel.y)).rgb;
+    sum += texture(texture0, fragTexCoord + vec2(0.0, texel.y)).rgb;
+    sum += texture(texture0, fragTexCoord + vec2(-h.x, -h.y)).rgb * 2.0;
+    sum += texture(texture0, fragTexCoord + vec2(h.x, -h.y)).rgb * 2.0;
+    sum += texture(texture0, fragTexCoord + vec2(-h.x, h.y)).rgb * 2.0;
+    sum += texture(texture0, fragTexCoord + vec2(h.x, h.y)).rgb * 2.0;
+    finalColor = vec4(sum / 12.0, 1.0);
+}
+)";
+
+// The scene is premultiplied by its coverage (see BeginCoverageBlend) and
+// goes over the opaque backdrop.
+constexpr const char* COMPOSITE_SHADER = R"(#version 330
+in vec2 fragTexCoord;
+uniform sampler2D texture0;
+uniform sampler2D backdrop;
+uniform sampler2D bloom;
+uniform float intensity;
+out vec4 finalColor;
+void main() {
+    vec4 scene = texture(texture0, fragTexCoord);
+    vec3 color = texture(backdrop, fragTexCoord).rgb * (1.0 - scene.a) + scene.rgb;
+    finalColor = vec4(color + texture(bloom, fragTexCoord).rgb * intensity, 1.0);
+}
+)";
+
+// Draws all of source over all of the current target.
+void Blit(const Texture2D& source, float width, float height) {
+    DrawTexturePro(source,
+                   {0.0f, 0.0f, static_cast<float>(source.width), -static_cast<float>(source.height)},
+                   {0.0f, 0.0f, width, height}, {0.0f, 0.0f}, 0.0f, WHITE);
+}
+
+void SetTexel(const Shader& shader, int loc, const Texture2D& source) {
+    const float texel[2] = {1.0f / static_cast<float>(source.width), 1.0f / static_cast<float>(source.height)};
+    SetShaderValue(shader, loc, texel, SHADER_UNIFORM_VEC2);
+}
+}
+
+Bloom::~Bloom() {
+    unloadLevels();
+    if (!ready) return;
+    UnloadShader(downShader);
+    UnloadShader(upShader);
+    UnloadShader(compositeShader);
+}
+
+void Bloom::Init(int width, int height) {
+    downShader = LoadShaderFromMemory(nullptr, DOWN_SHADER);
+    upShader = LoadShaderFromMemory(nullptr, UP_SHADER);
+    compositeShader = LoadShaderFromMemory(nullptr, COMPOSITE_SHADER);
+    const unsigned int fallback = rlGetShaderIdDefault();
+    if (downShader.id == fallback || upShader.id == fallback || compositeShader.id == fallback) {
+        // Free the ones that did build; UnloadShader skips the fallback.
+        UnloadShader(downShader);
+        UnloadShader(upShader);
+        UnloadShader(compositeShader);
+        downShader = {};
+        upShader = {};
+        compositeShader = {};
+        return;
+    }
+    downTexelLoc = GetShaderLocation(downShader, "texel");
+    downThresholdLoc = GetShaderLocation(downShader, "threshold");
+    upTexelLoc = GetShaderLocation(upShader, "texel");
+    compositeBackdropLoc = GetShaderLocation(compositeShader, "backdrop");
+    compositeBloomLoc = GetShaderLocation(compositeShader, "bloom");
+    compositeIntensityLoc = GetShaderLocation(compositeShader, "intensity");
+    ready = true;
+    Resize(width, height);
+}
+
+void Bloom::Resize(int width, int height) {
+    sceneWidth = width;
+    sceneHeight = height;
+    if (!ready) return;
+    unloadLevels();
+    loadLevels();
+}
+
+void Bloom::SetSettings(const BloomSettings& value) {
+    const bool resized = value.radius != settings.radius;
+    settings = value;
+    settings.radius = std::max(1, settings.radius);
+    if (resized && ready) {
+        unloadLevels();
+        loadLevels();
+    }
+}
+
+void Bloom::loadLevels() {
+    int w = sceneWidth / 2;
+    int h = sceneHeight / 2;
+    for (int i = 0; i < settings.radius && w >= MIN_LEVEL_SIZE && h >= MIN_LEVEL_SIZE; ++i) {
+        RenderTexture2D level = LoadRenderTexture(w, h);
+        SetTextureFilter(level.texture, TEXTURE_FILTER_BILINEAR);
+        SetTextureWrap(level.texture, TEXTURE_WRAP_CLAMP);
+        levels.push_back(level);
+        w /= 2;
+        h /= 2;
+    }
+}
+
+void Bloom::unloadLevels() {
+    for (RenderTexture2D& level : levels) UnloadRenderTexture(level);
+    levels.clear();
+}
+
+void Bloom::Render(const Texture2D& scene) {
+    if (!ready || levels.empty()) return;
+
+    const float threshold[3] = {settings.threshold, std::max(settings.knee, 0.0f), 1.0f};
+    const float passThrough[3] = {0.0f, 0.0f, 0.0f};
+    const Texture2D* source = &scene;
+    for (std::size_t i = 0; i < levels.size(); ++i) {
+        SetTexel(downShader, downTexelLoc, *source);
+        SetShaderValue(downShader, downThresholdLoc, i == 0 ? threshold : passThrough, SHADER_UNIFORM_VEC3);
+        BeginTextureMode(levels[i]);
+        BeginShaderMode(downShader);
+        Blit(*source, static_cast<float>(levels[i].texture.width), static_cast<float>(levels[i].texture.height));
+        EndShaderMode();
+        EndTextureMode();
+        source = &levels[i].texture;
+    }
+
+    // Each level keeps its own downsample and gains the blurred level below.
+    for (std::size_t i = levels.size() - 1; i > 0; --i) {
+        const Texture2D& below = levels[i].texture;
+        SetTexel(upShader, upTexelLoc, below);
+        BeginTextureMode(levels[i - 1]);
+        BeginBlendMode(BLEND_ADDITIVE);
+        BeginShaderMode(upShader);
+        Blit(below, static_cast<float>(levels[i - 1].texture.width), static_cast<float>(levels[i - 1].texture.height));
+        EndShaderMode();
+        EndBlendMode();
+        EndTextureMode();
+    }
+}
+
+void Bloom::Composite(const Texture2D& scene, const Texture2D& backdrop, float width, float height) {
+    if (!ready || levels.empty()) {
+        Blit(backdrop, width, height);
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        Blit(scene, width, height);
+        EndBlendMode();
+        return;
+    }
+    // The top level holds one copy per level; average them.
+    const float intensity = settings.intensity / static_cast<float>(levels.size());
+    SetShaderValue(compositeShader, compositeIntensityLoc, &intensity, SHADER_UNIFORM_FLOAT);
+    BeginShaderMode(compositeShader);
+    SetShaderValueTexture(compositeShader, compositeBackdropLoc, backdrop);
+    SetShaderValueTexture(compositeShader, compositeBloomLoc, levels[0].texture);
+    Blit(scene, width, height);
+    EndShaderMode();
+}
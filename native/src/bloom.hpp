@@ -0,0 +1,67 @@
+#pragma once
+
+#include <raylib.h>
+
+#include <vector>
+
+struct BloomSettings {
+    // Brightness (the largest channel, 0-1) above which pixels glow, eased in
+    // over knee below it.
+    float threshold{0.45f};
+    float knee{0.25f};
+    // Halvings in the blur chain; each one doubles the glow's reach.
+    int radius{5};
+    // Strength of the glow added over the scene.
+    float intensity{1.2f};
+};
+
+// Dual-filter bloom. A bright pass keeps what is over the threshold while
+// halving the scene; the result is halved radius - 1 more times with a
+// five-tap filter, then each level is blurred back up with an eight-tap
+// filter and added to the level above. Every pass runs at a fraction of the
+// scene's size, and Composite() adds the result in the same pass that lays
+// the scene over its backdrop, so the whole effect costs about a third of a
+// full-screen pass plus the copy.
+class Bloom {
+public:
+    Bloom() = default;
+    ~Bloom();
+    Bloom(const Bloom&) = delete;
+    Bloom& operator=(const Bloom&) = delete;
+
+    // Needs the window's GL context. Ready() is false if the shaders failed
+    // to build.
+    void Init(int width, int height);
+    void Resize(int width, int height);
+    bool Ready() const { return ready; }
+
+    void SetSettings(const BloomSettings& value);
+    const BloomSettings& GetSettings() const { return settings; }
+
+    // Blurs the bright parts of scene, which should filter bilinearly.
+    void Render(const Texture2D& scene);
+    // Draws scene over backdrop with the bloom added, both stretched over
+    // width x height of the current target. The scene's colour must be
+    // premultiplied by its alpha; the backdrop is opaque and never glows.
+    void Composite(const Texture2D& scene, const Texture2D& backdrop, float width, float height);
+
+private:
+    void loadLevels();
+    void unloadLevels();
+
+    BloomSettings settings;
+    int sceneWidth{0};
+    int sceneHeight{0};
+    std::vector<RenderTexture2D> levels;
+
+    Shader downShader{};
+    Shader upShader{};
+    Shader compositeShader{};
+    int downTexelLoc{-1};
+    int downThresholdLoc{-1};
+    int upTexelLoc{-1};
+    int compositeBackdropLoc{-1};
+    int compositeBloomLoc{-1};
+    int compositeIntensityLoc{-1};
+    bool ready{false};
+};
@@ -0,0 +1,79 @@
+#include "bridge_renderer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+Vector2 Quadratic(Vector2 a, Vector2 control, Vector2 b, float t) {
+    const float u = 1.0f - t;
+    return {u * u * a.x + 2.0f * u * t * control.x + t * t * b.x,
+            u * u * a.y + 2.0f * u * t * control.y + t * t * b.y};
+}
+}
+
+void BridgeRenderer::Build(Vector2 from, std::span<const Vector2> tips, float lift, const BridgeStroke& outer,
+                           const BridgeStroke& inner) {
+    source = from;
+    curves.clear();
+    strips.Clear();
+    for (const Vector2 tip : tips) {
+        const Vector2 control{(source.x + tip.x) * 0.5f, (source.y + tip.y) * 0.5f - lift};
+        // A quadratic's second derivative is constant, 2 (a - 2c + b), so n
+        // even steps stray at most |a - 2c + b| / (4 n^2) from the curve.
+        const float bendX = source.x - 2.0f * control.x + tip.x;
+        const float bendY = source.y - 2.0f * control.y + tip.y;
+        const float bend = std::sqrt(bendX * bendX + bendY * bendY);
+        const int segments = std::clamp(static_cast<int>(std::ceil(std::sqrt(bend / (4.0f * FLATNESS)))), 1,
+                                        MAX_SEGMENTS);
+        curves.push_back({control, tip, segments});
+        emitCurve(curves.back(), outer, inner);
+    }
+    strips.Upload();
+}
+
+Vector2 BridgeRenderer::PointOn(int curve, float t) const {
+    const Curve& c = curves[curve];
+    return Quadratic(source, c.control, c.tip, t);
+}
+
+void BridgeRenderer::emitCurve(const Curve& curve, const BridgeStroke& outer, const BridgeStroke& inner) {
+    const int joints = curve.segments + 1;
+    const StripMesh::Strips room = strips.Add(2, joints);
+    float* outerVertices = room.vertices;
+    float* innerVertices = outerVertices + joints * 6;
+    unsigned char* outerColors = room.colors;
+    unsigned char* innerColors = outerColors + joints * 8;
+
+    const float steps = static_cast<float>(curve.segments);
+    Vector2 p = source;
+    Vector2 out{0.0f, 0.0f};
+    for (int i = 0; i < joints; ++i) {
+        const Vector2 in = out;
+        const bool last = i == curve.segments;
+        const Vector2 next =
+            last ? p : Quadratic(source, curve.control, curve.tip, static_cast<float>(i + 1) / steps);
+        out = last ? Vector2{0.0f, 0.0f} : StripDirection(p, next);
+        const Vector2 unit = MiterOffset(in, out, 1.0f);
+
+        const auto put = [&](float*& vertices, unsigned char*& colors, const BridgeStroke& stroke) {
+            const float half = stroke.width * 0.5f;
+            vertices[0] = p.x + unit.x * half;
+            vertices[1] = p.y + unit.y * half;
+            vertices[2] = 0.0f;
+            vertices[3] = p.x - unit.x * half;
+            vertices[4] = p.y - unit.y * half;
+            vertices[5] = 0.0f;
+            vertices += 6;
+            for (int side = 0; side < 2; ++side) {
+                colors[0] = stroke.color.r;
+                colors[1] = stroke.color.g;
+                colors[2] = stroke.color.b;
+                colors[3] = stroke.color.a;
+                colors += 4;
+            }
+        };
+        put(outerVertices, outerColors, outer);
+        put(innerVertices, innerColors, inner);
+        p = next;
+    }
+}
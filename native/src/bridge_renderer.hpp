@@ -0,0 +1,52 @@
+#pragma once
+
+#include "strip_mesh.hpp"
+
+#include <raylib.h>
+
+#include <span>
+#include <vector>
+
+// Colour and full width of one stroke of the bridge's curves.
+struct BridgeStroke {
+    Color color;
+    float width;
+};
+
+// Draws the energy bridge: a quadratic curve from the core to every tentacle
+// tip, bowed upward, stroked twice (a wide outer glow under a narrow inner
+// line). Each curve's control point is worked out once in Build(), which
+// flattens it into as few segments as keep the polyline within FLATNESS
+// pixels of the true curve and writes all the strips into one StripMesh, so
+// the whole bridge is a single draw call. PointOn() reads the same curves to
+// place the particles riding them.
+class BridgeRenderer {
+public:
+    // Greatest distance, in pixels, between a curve and its segments.
+    static constexpr float FLATNESS = 0.25f;
+    static constexpr int MAX_SEGMENTS = 48;
+
+    // Builds and uploads the curves from source to each of tips, their
+    // middles raised by lift pixels. Each curve's outer stroke draws before
+    // its inner one.
+    void Build(Vector2 source, std::span<const Vector2> tips, float lift, const BridgeStroke& outer,
+               const BridgeStroke& inner);
+    void Draw() const { strips.Draw(); }
+
+    int Curves() const { return static_cast<int>(curves.size()); }
+    // The point a fraction t of the way along curve.
+    Vector2 PointOn(int curve, float t) const;
+
+private:
+    struct Curve {
+        Vector2 control;
+        Vector2 tip;
+        int segments;
+    };
+
+    void emitCurve(const Curve& curve, const BridgeStroke& outer, const BridgeStroke& inner);
+
+    Vector2 source{};
+    std::vector<Curve> curves;
+    StripMesh strips;
+};
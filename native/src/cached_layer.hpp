@@ -0,0 +1,87 @@
+#pragma once
+
+#include <raylib.h>
+#include <rlgl.h>
+
+#include <cmath>
+
+// Blending for drawing into a render texture cleared to transparent: colour
+// blends as usual, so it ends up premultiplied by coverage, while alpha
+// accumulates coverage. Drawing the texture with BLEND_ALPHA_PREMULTIPLY then
+// matches drawing the same things straight onto the target. End it with
+// EndBlendMode().
+inline void BeginCoverageBlend() {
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD,
+                              RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+}
+
+// A part of the screen kept in its own texture and redrawn only when Key,
+// which describes everything the drawing depends on, or the part's bounds
+// change. In between, showing it costs one textured quad. Key needs ==.
+template <typename Key>
+class CachedLayer {
+public:
+    CachedLayer() = default;
+    ~CachedLayer() { unload(); }
+    CachedLayer(const CachedLayer&) = delete;
+    CachedLayer& operator=(const CachedLayer&) = delete;
+
+    // Redraws the layer with draw(), which works in screen coordinates, if
+    // key or bounds differ from the last call. Bounds snap outward to whole
+    // pixels. Must not be called while another texture is being drawn to.
+    template <typename Draw>
+    void Update(Rectangle bounds, const Key& key, Draw&& draw) {
+        const Rectangle snapped{std::floor(bounds.x), std::floor(bounds.y),
+                                std::ceil(bounds.x + bounds.width) - std::floor(bounds.x),
+                                std::ceil(bounds.y + bounds.height) - std::floor(bounds.y)};
+        if (valid && key == last && snapped.x == area.x && snapped.y == area.y && snapped.width == area.width &&
+            snapped.height == area.height) {
+            return;
+        }
+        const int width = static_cast<int>(snapped.width);
+        const int height = static_cast<int>(snapped.height);
+        if (width <= 0 || height <= 0) return;
+        if (target.id == 0 || target.texture.width != width || target.texture.height != height) {
+            unload();
+            target = LoadRenderTexture(width, height);
+        }
+        area = snapped;
+        last = key;
+        valid = true;
+
+        BeginTextureMode(target);
+        ClearBackground(BLANK);
+        BeginCoverageBlend();
+        rlPushMatrix();
+        rlTranslatef(-area.x, -area.y, 0.0f);
+        draw();
+        rlPopMatrix();
+        EndBlendMode();
+        EndTextureMode();
+    }
+
+    void Invalidate() { valid = false; }
+
+    // Draws the layer where it was last updated.
+    void Draw() const {
+        if (!valid) return;
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        DrawTextureRec(target.texture, {0.0f, 0.0f, area.width, -area.height}, {area.x, area.y}, WHITE);
+        EndBlendMode();
+    }
+
+    const Texture2D& Texture() const { return target.texture; }
+
+private:
+    void unload() {
+        if (target.id != 0) UnloadRenderTexture(target);
+        target = {};
+        valid = false;
+    }
+
+    RenderTexture2D target{};
+    Rectangle area{};
+    Key last{};
+    bool valid{false};
+};
@@ -0,0 +1,163 @@
+#include "cpu_features.hpp"
+
+#include "simd.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ABYSSAL_HAVE_CPUID 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define ABYSSAL_HAVE_CPUID 1
+#endif
+
+namespace {
+struct CpuInfo {
+    bool sse2{false};
+    bool avx2{false};
+    bool avx512{false};
+};
+
+#if defined(ABYSSAL_HAVE_CPUID)
+void Cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<unsigned>(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0: which register states the OS saves on a context switch.
+unsigned long long ReadXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+}
+#endif
+
+CpuInfo QueryCpu() {
+    CpuInfo info;
+#if defined(ABYSSAL_HAVE_CPUID)
+    unsigned r[4];
+    Cpuid(0, 0, r);
+    const unsigned maxLeaf = r[0];
+    if (maxLeaf < 1) return info;
+    Cpuid(1, 0, r);
+    info.sse2 = (r[3] >> 26) & 1u;
+    const bool osxsave = (r[2] >> 27) & 1u;
+    const bool avx = (r[2] >> 28) & 1u;
+    // The CPU flags are not enough: the OS must also save the YMM state
+    // (and for AVX-512 the opmask and ZMM state).
+    const unsigned long long xcr0 = osxsave ? ReadXcr0() : 0;
+    const bool ymmState = (xcr0 & 0x6) == 0x6;
+    const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+    if (maxLeaf >= 7) {
+        Cpuid(7, 0, r);
+        info.avx2 = avx && ymmState && ((r[1] >> 5) & 1u);
+        // AVX-512F (bit 16) and AVX-512VL (bit 31).
+        info.avx512 = info.avx2 && zmmState && ((r[1] >> 16) & 1u) && ((r[1] >> 31) & 1u);
+    }
+#endif
+    return info;
+}
+
+const CpuInfo& Cpu() {
+    static const CpuInfo info = QueryCpu();
+    return info;
+}
+
+constexpr SimdIsa ALL_ISAS[] = {SimdIsa::Scalar, SimdIsa::Sse2, SimdIsa::Avx2, SimdIsa::Avx512};
+}
+
+bool IsSimdIsaSupported(SimdIsa isa) {
+    switch (isa) {
+    case SimdIsa::Scalar:
+        return true;
+    case SimdIsa::Sse2:
+#if defined(ABYSSAL_HAVE_SSE2)
+        return Cpu().sse2;
+#else
+        return false;
+#endif
+    case SimdIsa::Avx2:
+#if defined(ABYSSAL_BUILD_AVX2)
+        return Cpu().avx2;
+#else
+        return false;
+#endif
+    case SimdIsa::Avx512:
+#if defined(ABYSSAL_BUILD_AVX512)
+        return Cpu().avx512;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+SimdIsa SupportedSimdIsa(SimdIsa isa) {
+    while (isa != SimdIsa::Scalar && !IsSimdIsaSupported(isa)) {
+        isa = static_cast<SimdIsa>(static_cast<int>(isa) - 1);
+    }
+    return isa;
+}
+
+SimdIsa DetectSimdIsa() {
+    static const SimdIsa best = SupportedSimdIsa(SimdIsa::Avx512);
+    return best;
+}
+
+SimdIsa DefaultSimdIsa() {
+    static const SimdIsa isa = [] {
+        SimdIsa forced;
+        const char* name = std::getenv("ABYSSAL_SIMD");
+        if (name && ParseSimdIsa(name, forced)) return SupportedSimdIsa(forced);
+        return DetectSimdIsa();
+    }();
+    return isa;
+}
+
+const char* SimdIsaName(SimdIsa isa) {
+    switch (isa) {
+    case SimdIsa::Scalar:
+        return "scalar";
+    case SimdIsa::Sse2:
+        return "sse2";
+    case SimdIsa::Avx2:
+        return "avx2";
+    case SimdIsa::Avx512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+int SimdIsaWidth(SimdIsa isa) {
+    switch (isa) {
+    case SimdIsa::Scalar:
+        return 1;
+    case SimdIsa::Sse2:
+        return 4;
+    case SimdIsa::Avx2:
+    case SimdIsa::Avx512:
+        return 8;
+    }
+    return 1;
+}
+
+bool ParseSimdIsa(const char* name, SimdIsa& isa) {
+    for (SimdIsa candidate : ALL_ISAS) {
+        if (std::strcmp(name, SimdIsaName(candidate)) == 0) {
+            isa = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+// Instruction sets the lane kernels are built for, narrowest first. Avx512
+// runs the 8-lane kernels with AVX-512VL encodings (twice the vector
+// registers and mask compares); a bank block is 8 lanes, so there is no
+// 16-lane variant.
+enum class SimdIsa {
+    Scalar,
+    Sse2,
+    Avx2,
+    Avx512
+};
+
+// Widest instruction set both built into this binary and supported by the
+// CPU and OS, detected once with CPUID.
+SimdIsa DetectSimdIsa();
+bool IsSimdIsaSupported(SimdIsa isa);
+// isa if supported, otherwise the widest supported one narrower than it.
+SimdIsa SupportedSimdIsa(SimdIsa isa);
+// DetectSimdIsa(), unless the ABYSSAL_SIMD environment variable names an
+// instruction set (see SimdIsaName), which is then used if supported.
+SimdIsa DefaultSimdIsa();
+
+const char* SimdIsaName(SimdIsa isa);
+int SimdIsaWidth(SimdIsa isa);
+// Inverse of SimdIsaName; false for an unknown name.
+bool ParseSimdIsa(const char* name, SimdIsa& isa);
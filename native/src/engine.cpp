@@ -1,57 +1,70 @@
 #include "engine.hpp"
 
+#include "cached_layer.hpp"
+#include "fast_math.hpp"
+#include "math_util.hpp"
+
 #include <raymath.h>
+#include <rlgl.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <random>
-#include <sstream>
 
 namespace {
-constexpr float CAMERA_Z = 700.0f;
-constexpr float CAMERA_F = 600.0f;
-constexpr float PI2 = 2.0f * PI;
-
-struct ScreenPoint {
-    Vector2 pos;
-    float scale;
-    float z;
-};
-
-float ClampAngle(float angle) {
-    while (angle > PI) angle -= PI2;
-    while (angle < -PI) angle += PI2;
-    return angle;
-}
-
-float RandRange(float minValue, float maxValue) {
-    float t = static_cast<float>(GetRandomValue(0, 1000000)) / 1000000.0f;
-    return Lerp(minValue, maxValue, t);
-}
-
-ScreenPoint ProjectPoint(const Vector3& origin, const Vector3& point) {
-    float dx = point.x - origin.x;
-    float dy = point.y - origin.y;
-    float dz = point.z - origin.z;
-    float denom = fmaxf(0.001f, CAMERA_Z - dz);
-    float scale = CAMERA_F / denom;
-    return {{origin.x + dx * scale, origin.y + dy * scale}, scale, dz};
-}
-
-Color HexToColor(const char* hex) {
-    int r = 0, g = 0, b = 0;
+// Parses "#rrggbb"; anything else is black.
+constexpr Color HexToColor(const char* hex) {
+    const auto nibble = [](char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    unsigned int value = 0;
     if (hex && hex[0] == '#') {
-        unsigned int value = 0;
-        std::stringstream ss;
-        ss << std::hex << (hex + 1);
-        ss >> value;
-        r = (value >> 16) & 0xFF;
-        g = (value >> 8) & 0xFF;
-        b = value & 0xFF;
+        for (int i = 1; i <= 6; ++i) {
+            const int digit = nibble(hex[i]);
+            if (digit < 0) return Color{0, 0, 0, 255};
+            value = (value << 4) | static_cast<unsigned int>(digit);
+        }
     }
-    return Color{static_cast<unsigned char>(r), static_cast<unsigned char>(g), static_cast<unsigned char>(b), 255};
-}
+    return Color{static_cast<unsigned char>((value >> 16) & 0xFF), static_cast<unsigned char>((value >> 8) & 0xFF),
+                 static_cast<unsigned char>(value & 0xFF), 255};
+}
+
+constexpr std::array<Palette, 3> PALETTES{{
+    Palette{
+        "Neon Tide",
+        RGB{0, 200, 255},
+        RGB{0, 150, 255},
+        Palette::Orb{RGB{0, 190, 255, 255}, RGB{0, 120, 245, 204}, RGB{0, 40, 110, 0}},
+        Palette::Background{HexToColor("#020916"), HexToColor("#031c32"), HexToColor("#000a14"), RGB{120, 200, 255}},
+        Palette::Bridge{RGB{120, 225, 255}, RGB{20, 140, 255}},
+        RGB{0, 190, 255}
+    },
+    Palette{
+        "Solar Bloom",
+        RGB{255, 150, 40},
+        RGB{255, 80, 20},
+        Palette::Orb{RGB{255, 180, 70, 255}, RGB{255, 90, 50, 191}, RGB{120, 30, 0, 0}},
+        Palette::Background{HexToColor("#1a0524"), HexToColor("#32092c"), HexToColor("#140310"), RGB{255, 160, 90}},
+        Palette::Bridge{RGB{255, 200, 120}, RGB{255, 90, 40}},
+        RGB{255, 140, 70}
+    },
+    Palette{
+        "Abyss Warden",
+        RGB{120, 90, 255},
+        RGB{80, 60, 220},
+        Palette::Orb{RGB{190, 160, 255, 255}, RGB{120, 90, 255, 199}, RGB{20, 0, 60, 0}},
+        Palette::Background{HexToColor("#06011a"), HexToColor("#12082c"), HexToColor("#04010f"), RGB{160, 130, 255}},
+        Palette::Bridge{RGB{210, 190, 255}, RGB{110, 80, 250}},
+        RGB{170, 140, 255}
+    }
+}};
 
 Color FadeColor(const RGB& rgb, float alpha) {
     return {
@@ -62,379 +75,86 @@ Color FadeColor(const RGB& rgb, float alpha) {
     };
 }
 
-void DrawQuadraticCurve(const Vector2& a, const Vector2& b, const Vector2& c, Color color, float width) {
-    const int steps = 48;
-    Vector2 prev = a;
-    for (int i = 1; i <= steps; ++i) {
-        float t = static_cast<float>(i) / static_cast<float>(steps);
-        float u = 1.0f - t;
-        Vector2 point{
-            u * u * a.x + 2 * u * t * b.x + t * t * c.x,
-            u * u * a.y + 2 * u * t * b.y + t * t * c.y
-        };
-        DrawLineEx(prev, point, width, color);
-        prev = point;
-    }
-}
-}
-
-Tentacle::Tentacle(Core& coreRef, float baseAngleIn, float attachRadiusIn)
-    : core(coreRef), baseAngle(baseAngleIn), attachRadius(attachRadiusIn) {
-    anchorAngle = baseAngle;
-    animationSeed = RandRange(0.0f, 100.0f);
-    const int segmentCount = static_cast<int>(length);
-    segments.resize(segmentCount);
-    for (int i = 0; i < segmentCount; ++i) {
-        float dist = attachRadius + i * segmentLength;
-        float px = core.pos.x + cosf(baseAngle) * dist;
-        float py = core.pos.y + sinf(baseAngle) * dist;
-        segments[i].pos = {px, py, 0.0f};
-        segments[i].prev = segments[i].pos;
-        segments[i].offset = i * 0.3f + RandRange(0.0f, 0.5f);
+SimConfig WindowConfig(int width, int height, std::uint64_t seed) {
+    SimConfig config;
+    config.width = width;
+    config.height = height;
+    if (seed == 0) {
+        std::random_device device;
+        seed = (static_cast<std::uint64_t>(device()) << 32) | device();
     }
-    lastAttachX = segments.front().pos.x;
-    lastAttachY = segments.front().pos.y;
+    config.seed = seed;
+    return config;
 }
 
-const Vector3& Tentacle::Tip() const {
-    return segments.back().pos;
+// The HUD panel; the timer bar's top and size and the game over box's size
+// (both are centred across the window).
+constexpr Rectangle HUD_PANEL{20.0f, 60.0f, 260.0f, 178.0f};
+constexpr Rectangle TIMER_BAR{0.0f, 20.0f, 400.0f, 12.0f};
+constexpr Rectangle GAME_OVER_BOX{0.0f, 0.0f, 350.0f, 200.0f};
 }
 
-void Tentacle::Update(float dt, double timeMs, bool isActive, AnchorRing& ring, const std::vector<Tentacle>& neighbors) {
-    if (segments.empty()) return;
-
-    const float waveAmp = isActive ? waveAmpActive : waveAmpIdle;
-    const float waveSpeed = isActive ? waveSpeedActive : waveSpeedIdle;
-    const float damp = powf(airDamping, fmaxf(1.0f, dt * 60.0f));
-    const float time = static_cast<float>(timeMs * 0.001);
-
-    // Anchor dynamics
-    const float tx = -sinf(anchorAngle);
-    const float ty = cosf(anchorAngle);
-    const float baseRadius = fmaxf(attachRadius, 1.0f);
-    const float coreTang = (core.vx * tx + core.vy * ty) / baseRadius;
-    coreTangentialVelocity = coreTang;
-
-    float tension = 0.0f;
-    if (segments.size() > 1) {
-        const auto& s1 = segments[1].pos;
-        tension = ((s1.x - lastAttachX) * tx + (s1.y - lastAttachY) * ty) / fmaxf(segmentLength, 1.0f);
-    }
-
-    const float afr = powf(anchorFriction, fmaxf(1.0f, dt * 60.0f));
-    anchorAV = (anchorAV + anchorCoreInfluence * coreTang + anchorTensionInfluence * tension) * afr;
-
-    const float targetAngle = baseAngle + ring.offset;
-    float spacingError = ClampAngle(targetAngle - anchorAngle);
-    const float spacingGain = 0.8f;
-    anchorAV += spacingError * spacingGain;
-
-    const float repulsionStrength = 0.5f;
-    const float minAngle = PI2 / static_cast<float>(neighbors.size());
-    for (const auto& other : neighbors) {
-        if (&other == this) continue;
-        float diff = ClampAngle(other.AnchorAngle() - anchorAngle);
-        if (fabsf(diff) < minAngle * 0.8f) {
-            float sign = diff > 0 ? 1.0f : -1.0f;
-            anchorAV -= sign * repulsionStrength * ((minAngle * 0.8f) - fabsf(diff)) / (minAngle * 0.8f);
-        }
-    }
-
-    anchorAV = std::clamp(anchorAV, -anchorMaxAV, anchorMaxAV);
-
-    anchorAngle = ClampAngle(anchorAngle + anchorAV * dt);
-
-    const float attachX = core.pos.x + cosf(anchorAngle) * attachRadius;
-    const float attachY = core.pos.y + sinf(anchorAngle) * attachRadius;
-    const float attachZ = 0.0f;
-
-    auto& root = segments.front();
-    root.pos = {attachX, attachY, attachZ};
-    root.prev = root.pos;
-
-    for (size_t i = 1; i < segments.size(); ++i) {
-        auto& seg = segments[i];
-        float vx = (seg.pos.x - seg.prev.x) * damp;
-        float vy = (seg.pos.y - seg.prev.y) * damp;
-        float vz = (seg.pos.z - seg.prev.z) * damp;
-        float friction = frictionStrength;
-        seg.prev = seg.pos;
-        seg.pos.x += vx * (1.0f - friction);
-        seg.pos.y += vy * (1.0f - friction);
-        seg.pos.z += vz * (1.0f - friction);
-    }
-
-    const float vax = attachX - lastAttachX;
-    const float vay = attachY - lastAttachY;
-    const float vaz = attachZ - lastAttachZ;
-    if (segments.size() > 2) {
-        segments[1].pos.x += vax * 0.35f;
-        segments[1].pos.y += vay * 0.35f;
-        segments[2].pos.x += vax * 0.22f;
-        segments[2].pos.y += vay * 0.22f;
-    }
-
-    const int iter = iterations;
-    const float minRadius = attachRadius + collisionPad;
-
-    for (int pass = 0; pass < iter; ++pass) {
-        // distance constraints
-        for (size_t i = 1; i < segments.size(); ++i) {
-            auto& a = segments[i - 1];
-            auto& b = segments[i];
-            Vector3 delta = Vector3Subtract(b.pos, a.pos);
-            float dist = Vector3Length(delta);
-            if (dist < 1e-4f) dist = 1.0f;
-            float diff = (dist - segmentLength) / dist;
-            if (i - 1 == 0) {
-                b.pos.x -= delta.x * diff * 0.6f;
-                b.pos.y -= delta.y * diff * 0.6f;
-                b.pos.z -= delta.z * diff * 0.6f;
-            } else {
-                Vector3 corr{delta.x * diff * 0.5f, delta.y * diff * 0.5f, delta.z * diff * 0.5f};
-                a.pos = Vector3Add(a.pos, corr);
-                b.pos = Vector3Subtract(b.pos, corr);
-            }
-        }
-        root.pos = {attachX, attachY, attachZ};
-
-        // bend stiffness & wave
-        for (size_t i = 1; i + 1 < segments.size(); ++i) {
-            const auto& p0 = segments[i - 1].pos;
-            auto& p1 = segments[i].pos;
-            const auto& p2 = segments[i + 1].pos;
-
-            Vector3 mid{(p0.x + p2.x) * 0.5f, (p0.y + p2.y) * 0.5f, (p0.z + p2.z) * 0.5f};
-            Vector3 tangent = Vector3Normalize(Vector3Subtract(p2, p0));
-            if (Vector3Length(tangent) < 1e-4f) {
-                tangent = {0.0f, 1.0f, 0.0f};
-            }
-            Vector3 radial = Vector3Subtract(p1, core.pos);
-            float dotTR = Vector3DotProduct(radial, tangent);
-            Vector3 normal = Vector3Subtract(radial, Vector3Scale(tangent, dotTR));
-            normal.z += zBias * segmentLength;
-            float nlen = Vector3Length(normal);
-            if (nlen < 1e-4f) {
-                normal = {0.0f, 0.0f, 1.0f};
-                nlen = 1.0f;
-            }
-            normal = Vector3Scale(normal, 1.0f / nlen);
-
-            const float idxT = static_cast<float>(i) / static_cast<float>(segments.size() - 1);
-            const float env = 0.6f + (1.25f - 0.6f) * idxT;
-            const float coreGain = std::clamp(0.8f + 0.6f * fabsf(coreTangentialVelocity), 0.8f, 1.6f);
-            const float curvature = waveAmp * env * coreGain * sinf(time * waveSpeed - i * wavePhaseOffset + animationSeed);
-
-            Vector3 target = Vector3Add(mid, Vector3Scale(normal, curvature * segmentLength));
-            p1.x += (target.x - p1.x) * bendStiffness;
-            p1.y += (target.y - p1.y) * bendStiffness;
-            p1.z += (target.z - p1.z) * bendStiffness;
-        }
-
-        // collision with orb
-        for (size_t j = 1; j < segments.size(); ++j) {
-            auto& p = segments[j].pos;
-            Vector3 delta = Vector3Subtract(p, core.pos);
-            float dist = Vector3Length(delta);
-            if (dist < minRadius) {
-                if (dist < 1e-4f) {
-                    delta = {cosf(anchorAngle), sinf(anchorAngle), 0.0f};
-                    dist = 1.0f;
-                }
-                Vector3 normal = Vector3Scale(delta, 1.0f / dist);
-                p = Vector3Add(core.pos, Vector3Scale(normal, minRadius));
-            }
-        }
-        // segment-line collision vs orb
-        for (size_t j = 1; j < segments.size(); ++j) {
-            auto& a = segments[j - 1].pos;
-            auto& b = segments[j].pos;
-            Vector3 v = Vector3Subtract(b, a);
-            float denom = Vector3DotProduct(v, v);
-            if (denom < 1e-5f) continue;
-            Vector3 w = Vector3Subtract(core.pos, a);
-            float t = Vector3DotProduct(v, w) / denom;
-            t = std::clamp(t, 0.0f, 1.0f);
-            Vector3 c{a.x + v.x * t, a.y + v.y * t, a.z + v.z * t};
-            Vector3 delta = Vector3Subtract(c, core.pos);
-            float dist = Vector3Length(delta);
-            if (dist < minRadius) {
-                if (dist < 1e-4f) {
-                    delta = {cosf(anchorAngle), sinf(anchorAngle), 0.0f};
-                    dist = 1.0f;
-                }
-                Vector3 normal = Vector3Scale(delta, 1.0f / dist);
-                float push = (minRadius - dist);
-                b.x += normal.x * push;
-                b.y += normal.y * push;
-                b.z += normal.z * push;
-                if (j > 1) {
-                    a.x += normal.x * push * 0.2f;
-                    a.y += normal.y * push * 0.2f;
-                    a.z += normal.z * push * 0.2f;
-                }
-            }
-        }
-        root.pos = {attachX, attachY, attachZ};
-    }
-
-    lastAttachX = attachX;
-    lastAttachY = attachY;
-    lastAttachZ = attachZ;
-
-    core.avAccum += anchorAV;
-    core.avCount += 1;
+double RaylibClock::Seconds() {
+    return GetTime();
 }
 
-void Tentacle::CollectSegments(const Core& coreRef, std::vector<SegmentDraw>& back, std::vector<SegmentDraw>& front) const {
-    if (segments.size() < 2) return;
-    std::vector<ScreenPoint> projected(segments.size());
-    for (size_t i = 0; i < segments.size(); ++i) {
-        projected[i] = ProjectPoint(coreRef.pos, segments[i].pos);
-    }
-
-    for (size_t i = 1; i < segments.size(); ++i) {
-        const auto& a = projected[i - 1];
-        const auto& b = projected[i];
-        float avgZ = (segments[i - 1].pos.z + segments[i].pos.z) * 0.5f;
-        const float t = static_cast<float>(i) / static_cast<float>(segments.size() - 1);
-        const float baseW = 6.4f;
-        const float tipW = 3.2f;
-        float width = (baseW + (tipW - baseW) * t) * std::clamp((a.scale + b.scale) * 0.5f * 0.02f, 0.6f, 2.0f);
-        SegmentDraw seg{{a.pos.x, a.pos.y}, {b.pos.x, b.pos.y}, avgZ, width};
-        if (avgZ < 0.0f)
-            back.push_back(seg);
-        else
-            front.push_back(seg);
-    }
+SimInput RaylibInput::Poll() {
+    SimInput in;
+    in.mousePos = GetMousePosition();
+    in.mousePressed = IsMouseButtonPressed(MOUSE_BUTTON_LEFT);
+    in.mouseReleased = IsMouseButtonReleased(MOUSE_BUTTON_LEFT);
+    in.bridgeRequested = IsKeyPressed(KEY_SPACE);
+    in.restartRequested = IsKeyPressed(KEY_R);
+    return in;
 }
 
+Engine::Engine(int width, int height, std::uint64_t seed)
+    : screenWidth(width),
+      screenHeight(height),
+      sim(WindowConfig(width, height, seed)) {
+    renderCorePos = sim.GetCore().pos;
 
-Engine::Engine(int width, int height) : screenWidth(width), screenHeight(height) {
-    SetRandomSeed(static_cast<unsigned int>(GetTime() * 1000));
-    mousePos = {static_cast<float>(width) * 0.5f, static_cast<float>(height) * 0.5f};
-    core.pos = {mousePos.x, mousePos.y, 0.0f};
-    core.radius = 60.0f;
-
+    shapes.Init();
     // Initialize bloom render textures
     initBloom();
-
-    // Initialize prey
-    for (int i = 0; i < maxPrey; ++i) {
-        spawnPrey();
-    }
-
-    palettes = {
-        Palette{
-            "Neon Tide",
-            RGB{0, 200, 255},
-            RGB{0, 150, 255},
-            Palette::Orb{RGB{0, 190, 255, 255}, RGB{0, 120, 245, 204}, RGB{0, 40, 110, 0}},
-            Palette::Background{HexToColor("#020916"), HexToColor("#031c32"), HexToColor("#000a14"), RGB{120, 200, 255}},
-            Palette::Bridge{RGB{120, 225, 255}, RGB{20, 140, 255}},
-            RGB{0, 190, 255}
-        },
-        Palette{
-            "Solar Bloom",
-            RGB{255, 150, 40},
-            RGB{255, 80, 20},
-            Palette::Orb{RGB{255, 180, 70, 255}, RGB{255, 90, 50, 191}, RGB{120, 30, 0, 0}},
-            Palette::Background{HexToColor("#1a0524"), HexToColor("#32092c"), HexToColor("#140310"), RGB{255, 160, 90}},
-            Palette::Bridge{RGB{255, 200, 120}, RGB{255, 90, 40}},
-            RGB{255, 140, 70}
-        },
-        Palette{
-            "Abyss Warden",
-            RGB{120, 90, 255},
-            RGB{80, 60, 220},
-            Palette::Orb{RGB{190, 160, 255, 255}, RGB{120, 90, 255, 199}, RGB{20, 0, 60, 0}},
-            Palette::Background{HexToColor("#06011a"), HexToColor("#12082c"), HexToColor("#04010f"), RGB{160, 130, 255}},
-            Palette::Bridge{RGB{210, 190, 255}, RGB{110, 80, 250}},
-            RGB{170, 140, 255}
-        }
-    };
-
-    rebuildBackground(width, height);
-
-    const int tentacleCount = 30;
-    tentacles.reserve(tentacleCount);
-    for (int i = 0; i < tentacleCount; ++i) {
-        float angle = (PI2 / tentacleCount) * i;
-        tentacles.emplace_back(core, angle, core.radius);
-    }
 }
 
 Engine::~Engine() {
     if (bloomInitialized) {
         UnloadRenderTexture(sceneTexture);
-        UnloadRenderTexture(bloomTexture);
-        UnloadRenderTexture(blurTexture1);
-        UnloadRenderTexture(blurTexture2);
     }
 }
 
 void Engine::initBloom() {
-    sceneTexture = LoadRenderTexture(screenWidth, screenHeight);
-    bloomTexture = LoadRenderTexture(screenWidth / 2, screenHeight / 2);
-    blurTexture1 = LoadRenderTexture(screenWidth / 4, screenHeight / 4);
-    blurTexture2 = LoadRenderTexture(screenWidth / 4, screenHeight / 4);
+    bloom.Init(screenWidth, screenHeight);
+    if (!bloom.Ready()) return;
+    loadSceneTexture();
     bloomInitialized = true;
 }
 
 void Engine::resizeBloom(int width, int height) {
-    if (bloomInitialized) {
-        UnloadRenderTexture(sceneTexture);
-        UnloadRenderTexture(bloomTexture);
-        UnloadRenderTexture(blurTexture1);
-        UnloadRenderTexture(blurTexture2);
-    }
     screenWidth = width;
     screenHeight = height;
-    sceneTexture = LoadRenderTexture(width, height);
-    bloomTexture = LoadRenderTexture(width / 2, height / 2);
-    blurTexture1 = LoadRenderTexture(width / 4, height / 4);
-    blurTexture2 = LoadRenderTexture(width / 4, height / 4);
-}
-
-void Engine::spawnPrey() {
-    float margin = 100.0f;
-    Prey p;
-    p.pos = {
-        RandRange(margin, screenWidth - margin),
-        RandRange(margin, screenHeight - margin)
-    };
-    p.radius = RandRange(14.0f, 22.0f);
-    p.pulsePhase = RandRange(0.0f, PI2);
-    p.captured = false;
-    p.captureAnim = 0.0f;
-    p.spawnDelay = 0.0f;
-    prey.push_back(p);
+    if (!bloomInitialized) return;
+    UnloadRenderTexture(sceneTexture);
+    loadSceneTexture();
 }
 
-Palette& Engine::currentPalette() {
-    return palettes[paletteIndex];
+void Engine::loadSceneTexture() {
+    const float scale = resolution.Scale();
+    const int width = std::max(1, static_cast<int>(std::lround(screenWidth * scale)));
+    const int height = std::max(1, static_cast<int>(std::lround(screenHeight * scale)));
+    sceneTexture = LoadRenderTexture(width, height);
+    SetTextureFilter(sceneTexture.texture, TEXTURE_FILTER_BILINEAR);
+    SetTextureWrap(sceneTexture.texture, TEXTURE_WRAP_CLAMP);
+    bloom.Resize(width, height);
 }
 
 const Palette& Engine::currentPalette() const {
-    return palettes[paletteIndex];
+    return PALETTES[paletteIndex];
 }
 
 void Engine::handleInput() {
-    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-        mouseDown = true;
-        mousePos = GetMousePosition();
-        addRipple(mousePos);
-    } else if (IsMouseButtonReleased(MOUSE_BUTTON_LEFT)) {
-        mouseDown = false;
-    }
-
-    if (mouseDown) {
-        mousePos = GetMousePosition();
-    }
-
-    if (IsKeyPressed(KEY_SPACE)) {
-        bridge.pending = true;
-    }
     if (IsKeyPressed(KEY_Q)) {
         cyclePalette(-1);
     }
@@ -444,321 +164,119 @@ void Engine::handleInput() {
     if (IsKeyPressed(KEY_H)) {
         hudVisible = !hudVisible;
     }
-    if (IsKeyPressed(KEY_R)) {
-        resetGame();
-    }
 }
 
 void Engine::cyclePalette(int direction) {
-    const int total = static_cast<int>(palettes.size());
+    const int total = static_cast<int>(PALETTES.size());
     paletteIndex = (paletteIndex + direction) % total;
     if (paletteIndex < 0) paletteIndex += total;
-    rebuildBackground(screenWidth, screenHeight);
+    sim.RebuildBackground();
 }
 
-void Engine::addRipple(Vector2 pos) {
-    ripples.push_back({pos, nowMs, 0.9});
+void Engine::SetSimulationRate(float hz) {
+    sim.SetStepRate(hz);
 }
 
-void Engine::updateCore(float dt) {
-    const float stiffness = 0.02f;
-    const float drag = 0.85f;
-    Vector2 delta = Vector2Subtract(mousePos, Vector2{core.pos.x, core.pos.y});
-    if (mouseDown) {
-        core.vx += delta.x * stiffness;
-        core.vy += delta.y * stiffness;
-    }
-    core.vx *= drag;
-    core.vy *= drag;
-    core.pos.x += core.vx;
-    core.pos.y += core.vy;
+void Engine::SetSimdIsa(SimdIsa isa) {
+    sim.Tentacles().SetSimdIsa(isa);
 }
 
-void Engine::rebuildBackground(int width, int height) {
-    screenWidth = width;
-    screenHeight = height;
-    background.clear();
-    const float area = static_cast<float>(width * height);
-    const int density = std::clamp(static_cast<int>(area / 3600.0f), 90, 260);
-    background.reserve(density);
-    for (int i = 0; i < density; ++i) {
-        float depth = RandRange(0.25f, 1.0f);
-        background.push_back({
-            {RandRange(0.0f, static_cast<float>(width)), RandRange(0.0f, static_cast<float>(height))},
-            {(RandRange(-0.5f, 0.5f)) * 6.0f, (RandRange(-0.5f, 0.5f)) * 4.0f},
-            depth,
-            0.6f + depth * 1.4f,
-            RandRange(0.0f, 1.0f)
-        });
-    }
+void Engine::SetBloomSettings(const BloomSettings& settings) {
+    bloomSettings = settings;
+    applyQuality();
 }
 
-void Engine::updateBackground(float dt) {
-    const float parallaxFactor = 0.12f;
-    Vector2 coreDelta{core.vx * dt, core.vy * dt};
-    for (auto& p : background) {
-        float parallax = (1.0f - p.depth) * parallaxFactor;
-        p.pos.x -= core.vx * parallax;
-        p.pos.y -= core.vy * parallax;
-        p.pos.x += p.drift.x * dt;
-        p.pos.y += p.drift.y * dt;
-        p.twinkle = fmodf(p.twinkle + dt * 0.35f + RandRange(0.0f, 0.01f), 1.0f);
-        if (p.pos.x < -50) p.pos.x += screenWidth + 100;
-        else if (p.pos.x > screenWidth + 50) p.pos.x -= screenWidth + 100;
-        if (p.pos.y < -50) p.pos.y += screenHeight + 100;
-        else if (p.pos.y > screenHeight + 50) p.pos.y -= screenHeight + 100;
-    }
+void Engine::SetTargetFps(int fps) {
+    const float budget = 1.0f / static_cast<float>(fps > 0 ? fps : 60);
+    resolution.SetBudget(budget);
+    quality.SetBudget(budget);
 }
 
-void Engine::updateRipples() {
-    const double lifespan = 0.9;
-    ripples.erase(std::remove_if(ripples.begin(), ripples.end(), [&](const Ripple& r) {
-        return (nowMs - r.start) > (r.lifespan * 1000.0);
-    }), ripples.end());
+void Engine::SetRenderScale(float scale) {
+    resolution.Fix(scale);
+    if (!bloomInitialized) return;
+    UnloadRenderTexture(sceneTexture);
+    loadSceneTexture();
 }
 
-void Engine::maybeActivateEnergyBridge() {
-    if (!bridge.pending) return;
-    bridge.pending = false;
-    double elapsed = nowMs - bridge.lastTrigger;
-    if (bridge.isActive) return;
-    if (elapsed < bridge.cooldown * 1000.0) return;
-    bridge.isActive = true;
-    bridge.startTime = nowMs;
-    bridge.progress = 0.0f;
-    bridge.lastTrigger = nowMs;
-    bridge.particles.clear();
-    bridge.spawnAccumulator = 0.0f;
-    addRipple({core.pos.x, core.pos.y});
+void Engine::SetQualityTier(int tier) {
+    quality.Fix(tier);
+    applyQuality();
 }
 
-void Engine::updateEnergyBridge(float dt) {
-    if (!bridge.isActive) return;
-    const double elapsed = nowMs - bridge.startTime;
-    bridge.progress = std::clamp(static_cast<float>(elapsed / (bridge.duration * 1000.0)), 0.0f, 1.0f);
-    if (elapsed >= bridge.duration * 1000.0) {
-        bridge.isActive = false;
-        bridge.particles.clear();
-        return;
-    }
-
-    const int tipCount = static_cast<int>(tipCache.size());
-    const int targetParticles = std::min(120, std::max(1, tipCount * 4));
-    bridge.spawnAccumulator += dt * tipCount * 1.2f;
-    while (bridge.spawnAccumulator > 1.0f && static_cast<int>(bridge.particles.size()) < targetParticles) {
-        bridge.spawnAccumulator -= 1.0f;
-        bridge.particles.push_back({GetRandomValue(0, std::max(0, tipCount - 1)), RandRange(0.0f, 0.4f), RandRange(0.35f, 1.0f)});
-    }
-
-    for (auto it = bridge.particles.begin(); it != bridge.particles.end();) {
-        it->t += dt * it->speed;
-        if (it->t > 1.1f) {
-            it = bridge.particles.erase(it);
-        } else {
-            ++it;
-        }
-    }
+void Engine::applyQuality() {
+    const QualityTier& tier = quality.Current();
+    sim.SetQuality(tier.sim);
+    BloomSettings settings = bloomSettings;
+    settings.radius = std::min(settings.radius, tier.bloomRadius);
+    bloom.SetSettings(settings);
 }
 
-void Engine::updateTrails(float dt) {
-    // Spawn new trail particles at tentacle tips
-    for (const auto& tip : tipCache) {
-        if (GetRandomValue(0, 100) < 40) { // 40% chance per frame per tip
-            ScreenPoint projected = ProjectPoint(core.pos, tip);
-            TrailParticle tp;
-            tp.pos = projected.pos;
-            tp.vel = {RandRange(-15.0f, 15.0f), RandRange(-15.0f, 15.0f)};
-            tp.alpha = 0.8f;
-            tp.size = RandRange(2.0f, 5.0f);
-            tp.lifetime = 0.0f;
-            tp.maxLife = RandRange(0.3f, 0.7f);
-            trails.push_back(tp);
-        }
-    }
-
-    // Update existing trails
-    for (auto it = trails.begin(); it != trails.end();) {
-        it->lifetime += dt;
-        float lifeRatio = it->lifetime / it->maxLife;
-        it->alpha = 0.8f * (1.0f - lifeRatio);
-        it->size *= 0.97f;
-        it->pos.x += it->vel.x * dt;
-        it->pos.y += it->vel.y * dt;
-        it->vel.x *= 0.95f;
-        it->vel.y *= 0.95f;
-
-        if (it->lifetime >= it->maxLife || it->alpha < 0.01f) {
-            it = trails.erase(it);
-        } else {
-            ++it;
-        }
-    }
-
-    // Limit max trails
-    const size_t maxTrails = 500;
-    while (trails.size() > maxTrails) {
-        trails.erase(trails.begin());
-    }
-}
-
-void Engine::updatePrey(float dt) {
-    const float time = static_cast<float>(nowMs * 0.001);
-
-    for (auto& p : prey) {
-        if (p.captured) {
-            p.captureAnim += dt * 3.0f;
-            if (p.captureAnim >= 1.0f && !gameOver) {
-                // Respawn after delay (only if game is still running)
-                p.spawnDelay += dt;
-                if (p.spawnDelay > 2.0f) {
-                    float margin = 100.0f;
-                    p.pos = {
-                        RandRange(margin, screenWidth - margin),
-                        RandRange(margin, screenHeight - margin)
-                    };
-                    p.radius = RandRange(14.0f, 22.0f);
-                    p.captured = false;
-                    p.captureAnim = 0.0f;
-                    p.spawnDelay = 0.0f;
-                }
-            }
-            continue;
-        }
-
-        // Update pulse
-        p.pulsePhase = fmodf(p.pulsePhase + dt * 3.0f, PI2);
-
-        // Check collision with tentacle tips (only if game is running)
-        if (!gameOver) {
-            for (const auto& tip : tipCache) {
-                ScreenPoint projected = ProjectPoint(core.pos, tip);
-                float dx = projected.pos.x - p.pos.x;
-                float dy = projected.pos.y - p.pos.y;
-                float dist = sqrtf(dx * dx + dy * dy);
-                if (dist < p.radius + 8.0f) {
-                    p.captured = true;
-                    p.captureAnim = 0.0f;
-                    score += 10;
-                    addRipple(p.pos);
-                    break;
-                }
-            }
-        }
-
-        // Gentle drift away from core
-        float toCoreDx = p.pos.x - core.pos.x;
-        float toCoreDy = p.pos.y - core.pos.y;
-        float toCoreLen = sqrtf(toCoreDx * toCoreDx + toCoreDy * toCoreDy);
-        if (toCoreLen > 1.0f && toCoreLen < 300.0f) {
-            float flee = 20.0f / toCoreLen;
-            p.pos.x += (toCoreDx / toCoreLen) * flee * dt;
-            p.pos.y += (toCoreDy / toCoreLen) * flee * dt;
-        }
-
-        // Keep in bounds
-        float margin = 50.0f;
-        if (p.pos.x < margin) p.pos.x = margin;
-        if (p.pos.x > screenWidth - margin) p.pos.x = screenWidth - margin;
-        if (p.pos.y < margin) p.pos.y = margin;
-        if (p.pos.y > screenHeight - margin) p.pos.y = screenHeight - margin;
-    }
-}
-
-void Engine::updateTimer(float dt) {
-    if (gameOver) return;
-
-    gameTimer -= dt;
-    if (gameTimer <= 0.0f) {
-        gameTimer = 0.0f;
-        gameOver = true;
-        if (score > highScore) {
-            highScore = score;
-        }
-    }
-}
-
-void Engine::resetGame() {
-    gameTimer = maxTime;
-    gameOver = false;
-    score = 0;
-
-    // Reset all prey
-    prey.clear();
-    for (int i = 0; i < maxPrey; ++i) {
-        spawnPrey();
-    }
-}
-
-void Engine::Update(float dt) {
-    nowMs = GetTime() * 1000.0;
+void Engine::Update() {
     if (IsWindowResized()) {
         int newWidth = GetScreenWidth();
         int newHeight = GetScreenHeight();
-        rebuildBackground(newWidth, newHeight);
+        sim.Resize(newWidth, newHeight);
         resizeBloom(newWidth, newHeight);
     }
-
-    handleInput();
-    updateTimer(dt);
-    updateCore(dt);
-    updateBackground(dt);
-    updateRipples();
-    maybeActivateEnergyBridge();
-
-    core.avAccum = 0.0f;
-    core.avCount = 0;
-
-    tipCache.clear();
-    backSegments.clear();
-    frontSegments.clear();
-
-    for (auto& t : tentacles) {
-        t.Update(dt, nowMs, mouseDown, ring, tentacles);
-        tipCache.push_back(t.Tip());
-        t.CollectSegments(core, backSegments, frontSegments);
+    // GetFrameTime() covers the last frame, whose simulation took
+    // simSeconds; the rest went on drawing and presenting it. Each
+    // controller acts on the part it can cut: the render scale only shrinks
+    // drawing, and the tiers mostly cut the simulation. Only the offscreen
+    // scene can be scaled.
+    const float frameSeconds = GetFrameTime();
+    if (bloomInitialized && resolution.Update(frameSeconds, simSeconds)) {
+        UnloadRenderTexture(sceneTexture);
+        loadSceneTexture();
     }
-
-    if (core.avCount > 0) {
-        const float afr = powf(ring.friction, fmaxf(1.0f, dt * 60.0f));
-        const float avg = core.avAccum / static_cast<float>(core.avCount);
-        ring.angularVelocity = (ring.angularVelocity + avg) * afr;
-        ring.angularVelocity = std::clamp(ring.angularVelocity, -ring.maxAV, ring.maxAV);
-        ring.offset = ClampAngle(ring.offset + ring.angularVelocity * dt);
+    if (quality.Update(frameSeconds, simSeconds)) {
+        applyQuality();
+        TraceLog(LOG_INFO, "QUALITY: %s tier (median %.1f ms, simulation %.1f ms, 95th percentile %.1f ms)",
+                 quality.Current().name, quality.Median() * 1000.0f, quality.SimMedian() * 1000.0f,
+                 quality.Slowest() * 1000.0f);
     }
 
-    updateEnergyBridge(dt);
-    updateTrails(dt);
-    updatePrey(dt);
+    const double simStart = GetTime();
+    handleInput();
+    sim.Frame(input, clock);
+    simSeconds = static_cast<float>(GetTime() - simStart);
 }
 
-void Engine::drawBackground() const {
+void Engine::drawGradient() const {
     const auto& palette = currentPalette();
     DrawRectangleGradientV(0, 0, screenWidth, screenHeight, palette.background.top, palette.background.bottom);
-    for (const auto& p : background) {
+}
+
+void Engine::drawStars() {
+    const auto& palette = currentPalette();
+    for (const auto& p : sim.Background()) {
         float alpha = 0.2f + p.twinkle * 0.6f;
         Color color = FadeColor(palette.background.star, alpha);
         float size = p.size * (0.8f + p.twinkle * 0.6f);
-        DrawCircleV(p.pos, size, color);
+        shapes.Circle(p.pos, size, color);
     }
+    shapes.Flush();
 }
 
-void Engine::drawRipples() const {
+void Engine::drawRipples() {
     const auto& palette = currentPalette();
-    for (const auto& ripple : ripples) {
-        double age = nowMs - ripple.start;
+    for (const auto& ripple : sim.Ripples()) {
+        double age = sim.NowMs() - ripple.start;
         double t = (age / (ripple.lifespan * 1000.0));
         if (t < 0 || t > 1) continue;
         float radius = 30.0f + static_cast<float>(t) * 180.0f;
         float alpha = std::clamp(1.0f - static_cast<float>(t), 0.0f, 1.0f);
         Color color = FadeColor(palette.ripple, alpha * 0.35f);
-        DrawRing(ripple.pos, radius - 2.0f, radius, 0.0f, 360.0f, 48, color);
+        shapes.Ring(ripple.pos, radius - 2.0f, radius, color);
     }
+    shapes.Flush();
 }
 
-void Engine::drawCore() const {
+void Engine::drawCore() {
     const auto& palette = currentPalette();
-    ScreenPoint projected = ProjectPoint(core.pos, core.pos);
-    float r = core.radius * projected.scale;
+    const EnergyBridge& bridge = sim.Bridge();
+    ScreenPoint projected = ProjectPoint(renderCorePos, renderCorePos);
+    float r = sim.GetCore().radius * projected.scale;
     for (int i = 0; i < 3; ++i) {
         float t = static_cast<float>(i) / 2.0f;
         float radius = r * (1.0f + t * 0.35f);
@@ -767,141 +285,161 @@ void Engine::drawCore() const {
         if (i == 0) color = &palette.orb.inner;
         else if (i == 1) color = &palette.orb.mid;
         else color = &palette.orb.outer;
-        DrawCircleV({core.pos.x, core.pos.y}, radius, color->ToColor(alpha));
+        shapes.Circle({renderCorePos.x, renderCorePos.y}, radius, color->ToColor(alpha));
     }
     if (bridge.isActive) {
-        float pulse = 0.4f + sinf(static_cast<float>(PI) * bridge.progress) * 0.35f;
-        DrawRing({core.pos.x, core.pos.y}, r * (1.05f + pulse * 0.1f), r * (1.1f + pulse * 0.2f), 0.0f, 360.0f, 64,
-                 FadeColor(palette.bridge.inner, 0.35f + pulse * 0.3f));
+        float pulse = 0.4f + FastSin(static_cast<float>(PI) * bridge.progress) * 0.35f;
+        shapes.Ring({renderCorePos.x, renderCorePos.y}, r * (1.05f + pulse * 0.1f), r * (1.1f + pulse * 0.2f),
+                    FadeColor(palette.bridge.inner, 0.35f + pulse * 0.3f));
     }
+    shapes.Flush();
 }
 
 void Engine::drawTentacles() {
     const auto& palette = currentPalette();
-    auto drawList = [&](std::vector<SegmentDraw>& list, bool back) {
-        std::sort(list.begin(), list.end(), [&](const SegmentDraw& a, const SegmentDraw& b) {
-            return back ? (a.avgZ < b.avgZ) : (a.avgZ > b.avgZ);
-        });
-        for (const auto& seg : list) {
-            float depthAlpha = std::clamp(0.7f + (seg.avgZ / (core.radius * 2.0f)), 0.2f, 1.0f);
-            Color color = FadeColor(palette.tentacle, depthAlpha);
-            DrawLineEx(seg.a, seg.b, seg.width, color);
-            DrawLineEx(seg.a, seg.b, seg.width * 0.6f, FadeColor(palette.glow, depthAlpha * 0.6f));
-        }
-    };
-
-    drawList(backSegments, true);
+    tentacleMesh.Build(chains, FadeColor(palette.tentacle, 1.0f), FadeColor(palette.glow, 0.6f));
+    tentacleMesh.DrawBack();
     drawCore();
-    drawList(frontSegments, false);
+    tentacleMesh.DrawFront();
 }
 
 void Engine::drawEnergyBridge() {
-    if (!bridge.isActive || tipCache.empty()) return;
+    const EnergyBridge& bridge = sim.Bridge();
+    if (!bridge.isActive || renderTips.empty()) return;
     const auto& palette = currentPalette();
-    float ease = sinf(static_cast<float>(PI) * bridge.progress);
-    Vector2 source{core.pos.x, core.pos.y};
-    const int stride = std::max(1, static_cast<int>(tipCache.size() / 8));
-
-    for (size_t i = 0; i < tipCache.size(); i += stride) {
-        ScreenPoint tipProj = ProjectPoint(core.pos, tipCache[i]);
-        Vector2 tip{tipProj.pos.x, tipProj.pos.y};
-        Vector2 mid{(source.x + tip.x) * 0.5f, (source.y + tip.y) * 0.5f - 80.0f * ease};
-        DrawQuadraticCurve(source, mid, tip, FadeColor(palette.bridge.outer, 0.25f + ease * 0.35f), 2.4f + ease * 1.6f);
-        DrawQuadraticCurve(source, mid, tip, FadeColor(palette.bridge.inner, 0.55f + ease * 0.25f), 1.2f + ease * 1.2f);
-    }
+    float ease = FastSin(static_cast<float>(PI) * bridge.progress);
+    const Vector2 source{renderCorePos.x, renderCorePos.y};
+
+    bridgeTips.clear();
+    for (const Vector3& tip : renderTips) bridgeTips.push_back(ProjectPoint(renderCorePos, tip).pos);
+    bridgeRenderer.Build(source, bridgeTips, 80.0f * ease,
+                         {FadeColor(palette.bridge.outer, 0.25f + ease * 0.35f), 2.4f + ease * 1.6f},
+                         {FadeColor(palette.bridge.inner, 0.55f + ease * 0.25f), 1.2f + ease * 1.2f});
+    bridgeRenderer.Draw();
 
     for (const auto& particle : bridge.particles) {
-        if (particle.tipIndex < 0 || particle.tipIndex >= static_cast<int>(tipCache.size())) continue;
-        ScreenPoint tipProj = ProjectPoint(core.pos, tipCache[particle.tipIndex]);
-        Vector2 tip{tipProj.pos.x, tipProj.pos.y};
-        Vector2 mid{(source.x + tip.x) * 0.5f, (source.y + tip.y) * 0.5f - 80.0f * ease};
-        float t = particle.t;
-        float u = 1.0f - t;
-        Vector2 point{
-            u * u * source.x + 2 * u * t * mid.x + t * t * tip.x,
-            u * u * source.y + 2 * u * t * mid.y + t * t * tip.y
-        };
-        float alpha = std::clamp(0.35f + sinf(t * PI) * 0.55f, 0.0f, 1.0f);
-        DrawCircleV(point, 3.2f + sinf(t * PI) * 1.8f, FadeColor(palette.bridge.inner, alpha));
+        if (particle.tipIndex < 0 || particle.tipIndex >= bridgeRenderer.Curves()) continue;
+        const Vector2 point = bridgeRenderer.PointOn(particle.tipIndex, particle.t);
+        float arc = FastSin(particle.t * PI);
+        float alpha = std::clamp(0.35f + arc * 0.55f, 0.0f, 1.0f);
+        shapes.Circle(point, 3.2f + arc * 1.8f, FadeColor(palette.bridge.inner, alpha));
+    }
+    shapes.Flush();
+}
+
+void Engine::drawTimer() {
+    const float gameTimer = sim.TimeLeft();
+    const float fillRatio = gameTimer / sim.MaxTime();
+    const int seconds = static_cast<int>(gameTimer);
+    TimerState state;
+    state.palette = paletteIndex;
+    state.tenths = seconds * 10 + static_cast<int>((gameTimer - seconds) * 10);
+    state.fill = fillRatio > 0.0f ? static_cast<int>(std::lround(TIMER_BAR.width * fillRatio)) : 0;
+    state.low = fillRatio <= 0.25f;
+    const float barX = (screenWidth - TIMER_BAR.width) * 0.5f;
+    // The bar's backing, and the text below it.
+    timerLayer.Update({barX - 4.0f, TIMER_BAR.y - 4.0f, TIMER_BAR.width + 8.0f, TIMER_BAR.height + 44.0f}, state,
+                      [&] { drawTimerBar(state, barX); });
+    timerLayer.Draw();
+
+    // Game over overlay
+    if (sim.GameOver()) {
+        // Darken screen
+        DrawRectangle(0, 0, screenWidth, screenHeight, Color{0, 0, 0, 150});
+
+        const float boxX = (screenWidth - GAME_OVER_BOX.width) * 0.5f;
+        const float boxY = (screenHeight - GAME_OVER_BOX.height) * 0.5f;
+        const GameOverState scores{paletteIndex, sim.Score(), sim.HighScore()};
+        // The border is drawn outside the box.
+        gameOverLayer.Update({boxX - 4.0f, boxY - 4.0f, GAME_OVER_BOX.width + 8.0f, GAME_OVER_BOX.height + 8.0f},
+                             scores, [&] { drawGameOverBox(scores, boxX, boxY); });
+        gameOverLayer.Draw();
     }
 }
 
-void Engine::drawTimer() const {
+void Engine::drawTimerBar(const TimerState& state, float barX) const {
     const auto& palette = currentPalette();
-
-    // Draw timer bar at top of screen
-    float barWidth = 400.0f;
-    float barHeight = 12.0f;
-    float barX = (screenWidth - barWidth) * 0.5f;
-    float barY = 20.0f;
+    const float barY = TIMER_BAR.y;
+    const float barWidth = TIMER_BAR.width;
+    const float barHeight = TIMER_BAR.height;
 
     // Background
     DrawRectangleRounded({barX - 4, barY - 4, barWidth + 8, barHeight + 8}, 0.5f, 8, Color{10, 18, 42, 200});
 
     // Timer fill
-    float fillRatio = gameTimer / maxTime;
-    Color fillColor = fillRatio > 0.25f ? FadeColor(palette.bridge.inner, 0.9f) : FadeColor(RGB{255, 80, 80}, 0.9f);
-    if (fillRatio > 0.0f) {
-        DrawRectangleRounded({barX, barY, barWidth * fillRatio, barHeight}, 0.5f, 8, fillColor);
+    Color fillColor = state.low ? FadeColor(RGB{255, 80, 80}, 0.9f) : FadeColor(palette.bridge.inner, 0.9f);
+    if (state.fill > 0) {
+        DrawRectangleRounded({barX, barY, static_cast<float>(state.fill), barHeight}, 0.5f, 8, fillColor);
     }
 
     // Timer text
-    int seconds = static_cast<int>(gameTimer);
-    int tenths = static_cast<int>((gameTimer - seconds) * 10);
     char timerText[32];
-    snprintf(timerText, sizeof(timerText), "%d.%d", seconds, tenths);
+    snprintf(timerText, sizeof(timerText), "%d.%d", state.tenths / 10, state.tenths % 10);
 
     int textWidth = MeasureText(timerText, 24);
     DrawText(timerText, (screenWidth - textWidth) / 2, barY + barHeight + 8, 24, WHITE);
+}
 
-    // Game over overlay
-    if (gameOver) {
-        // Darken screen
-        DrawRectangle(0, 0, screenWidth, screenHeight, Color{0, 0, 0, 150});
+void Engine::drawGameOverBox(const GameOverState& scores, float boxX, float boxY) const {
+    const auto& palette = currentPalette();
+    const float boxWidth = GAME_OVER_BOX.width;
+    const float boxHeight = GAME_OVER_BOX.height;
 
-        // Game over box
-        float boxWidth = 350.0f;
-        float boxHeight = 200.0f;
-        float boxX = (screenWidth - boxWidth) * 0.5f;
-        float boxY = (screenHeight - boxHeight) * 0.5f;
+    DrawRectangleRounded({boxX, boxY, boxWidth, boxHeight}, 0.1f, 8, Color{10, 18, 42, 240});
+    DrawRectangleRoundedLines({boxX, boxY, boxWidth, boxHeight}, 0.1f, 8, 3.0f, FadeColor(palette.bridge.inner, 0.8f));
 
-        DrawRectangleRounded({boxX, boxY, boxWidth, boxHeight}, 0.1f, 8, Color{10, 18, 42, 240});
-        DrawRectangleRoundedLines({boxX, boxY, boxWidth, boxHeight}, 0.1f, 8, 3.0f, FadeColor(palette.bridge.inner, 0.8f));
+    const char* gameOverText = "TIME'S UP!";
+    int goWidth = MeasureText(gameOverText, 36);
+    DrawText(gameOverText, (screenWidth - goWidth) / 2, boxY + 30, 36, FadeColor(palette.bridge.inner, 1.0f));
 
-        const char* gameOverText = "TIME'S UP!";
-        int goWidth = MeasureText(gameOverText, 36);
-        DrawText(gameOverText, (screenWidth - goWidth) / 2, boxY + 30, 36, FadeColor(palette.bridge.inner, 1.0f));
+    char finalScore[64];
+    snprintf(finalScore, sizeof(finalScore), "Final Score: %d", scores.score);
+    int fsWidth = MeasureText(finalScore, 28);
+    DrawText(finalScore, (screenWidth - fsWidth) / 2, boxY + 80, 28, WHITE);
 
-        char finalScore[64];
-        snprintf(finalScore, sizeof(finalScore), "Final Score: %d", score);
-        int fsWidth = MeasureText(finalScore, 28);
-        DrawText(finalScore, (screenWidth - fsWidth) / 2, boxY + 80, 28, WHITE);
+    char highScoreText[64];
+    snprintf(highScoreText, sizeof(highScoreText), "High Score: %d", scores.highScore);
+    int hsWidth = MeasureText(highScoreText, 22);
+    DrawText(highScoreText, (screenWidth - hsWidth) / 2, boxY + 115, 22, FadeColor(palette.glow, 0.8f));
 
-        char highScoreText[64];
-        snprintf(highScoreText, sizeof(highScoreText), "High Score: %d", highScore);
-        int hsWidth = MeasureText(highScoreText, 22);
-        DrawText(highScoreText, (screenWidth - hsWidth) / 2, boxY + 115, 22, FadeColor(palette.glow, 0.8f));
+    const char* restartText = "Press R to restart";
+    int rWidth = MeasureText(restartText, 20);
+    DrawText(restartText, (screenWidth - rWidth) / 2, boxY + 160, 20, FadeColor(palette.tentacle, 0.9f));
+}
 
-        const char* restartText = "Press R to restart";
-        int rWidth = MeasureText(restartText, 20);
-        DrawText(restartText, (screenWidth - rWidth) / 2, boxY + 160, 20, FadeColor(palette.tentacle, 0.9f));
+void Engine::drawHud() {
+    if (!hudVisible) return;
+    const EnergyBridge& bridge = sim.Bridge();
+    const TentacleBank& tentacles = sim.Tentacles();
+    HudState state;
+    state.palette = paletteIndex;
+    state.score = sim.Score();
+    state.solver = tentacles.GetSolverPath() == SolverPath::Scalar ? -1 : static_cast<int>(tentacles.GetSimdIsa());
+    state.bridge = HudState::BRIDGE_READY;
+    if (bridge.isActive) state.bridge = HudState::BRIDGE_ACTIVE;
+    else {
+        double remaining = (bridge.cooldown * 1000.0) - (sim.NowMs() - bridge.lastTrigger);
+        if (remaining > 50) state.bridge = static_cast<int>(std::lround(remaining / 100.0));
     }
+    // The border is drawn outside the panel.
+    hudLayer.Update({HUD_PANEL.x - 4.0f, HUD_PANEL.y - 4.0f, HUD_PANEL.width + 8.0f, HUD_PANEL.height + 8.0f}, state,
+                    [&] { drawHudPanel(state); });
+    hudLayer.Draw();
 }
 
-void Engine::drawHud() const {
-    if (!hudVisible) return;
+void Engine::drawHudPanel(const HudState& state) const {
     const auto& palette = currentPalette();
-    Rectangle rect{20.0f, 60.0f, 260.0f, 160.0f};
+    const Rectangle rect = HUD_PANEL;
     Color bg{10, 18, 42, 180};
     DrawRectangleRounded(rect, 0.1f, 8, bg);
     DrawRectangleRoundedLines(rect, 0.1f, 8, 2.0f, FadeColor(palette.glow, 0.4f));
 
     int fontSizeTitle = 20;
-    DrawText(palette.name.c_str(), rect.x + 16, rect.y + 12, fontSizeTitle, WHITE);
+    DrawText(palette.name, rect.x + 16, rect.y + 12, fontSizeTitle, WHITE);
 
     // Score display
     char scoreText[32];
-    snprintf(scoreText, sizeof(scoreText), "Score: %d", score);
+    snprintf(scoreText, sizeof(scoreText), "Score: %d", state.score);
     DrawText(scoreText, rect.x + 140, rect.y + 12, 20, FadeColor(palette.bridge.inner, 1.0f));
 
     DrawText("Catch the orbs!", rect.x + 16, rect.y + 40, 14, FadeColor(palette.glow, 0.7f));
@@ -914,159 +452,134 @@ void Engine::drawHud() const {
     DrawText("Q/E: Palettes  H: HUD", rect.x + 16, y, 14, FadeColor(palette.tentacle, 0.8f));
     y += 18;
     DrawText("R: Restart game", rect.x + 16, y, 14, FadeColor(palette.ripple, 0.8f));
+    y += 18;
+    char kernelText[48];
+    if (state.solver < 0) {
+        snprintf(kernelText, sizeof(kernelText), "Solver: reference");
+    } else {
+        const SimdIsa isa = static_cast<SimdIsa>(state.solver);
+        snprintf(kernelText, sizeof(kernelText), "Solver: %s x%d", SimdIsaName(isa), SimdIsaWidth(isa));
+    }
+    DrawText(kernelText, rect.x + 16, y, 14, FadeColor(palette.glow, 0.7f));
 
-    std::string status = "Ready";
-    if (bridge.isActive) status = "Bridge active";
-    else {
-        double remaining = (bridge.cooldown * 1000.0) - (nowMs - bridge.lastTrigger);
-        if (remaining > 50) {
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "Recharging (%.1fs)", remaining / 1000.0);
-            status = buffer;
-        }
+    char status[64];
+    if (state.bridge == HudState::BRIDGE_ACTIVE) {
+        snprintf(status, sizeof(status), "Bridge active");
+    } else if (state.bridge == HudState::BRIDGE_READY) {
+        snprintf(status, sizeof(status), "Ready");
+    } else {
+        snprintf(status, sizeof(status), "Recharging (%.1fs)", state.bridge / 10.0);
     }
-    DrawText(status.c_str(), rect.x + 16, rect.y + rect.height - 28, 14, FadeColor(palette.bridge.inner, 0.9f));
+    DrawText(status, rect.x + 16, rect.y + rect.height - 28, 14, FadeColor(palette.bridge.inner, 0.9f));
 }
 
-void Engine::drawTrails() const {
+void Engine::drawTrails() {
     const auto& palette = currentPalette();
-    for (const auto& t : trails) {
+    const TrailParticles& trails = sim.Trails();
+    for (std::size_t i = 0; i < trails.Count(); ++i) {
+        const TrailParticle t = trails.At(i);
         Color color = FadeColor(palette.glow, t.alpha * 0.6f);
-        DrawCircleV(t.pos, t.size, color);
+        shapes.Circle(t.pos, t.size, color);
     }
+    shapes.Flush();
 }
 
-void Engine::drawPrey() const {
+void Engine::drawPrey() {
     const auto& palette = currentPalette();
-    const float time = static_cast<float>(nowMs * 0.001);
+    const float time = static_cast<float>(sim.NowMs() * 0.001);
 
-    for (const auto& p : prey) {
+    for (const auto& p : sim.PreyList()) {
         if (p.captured) {
             // Capture animation - expanding ring that fades
             float anim = p.captureAnim;
             if (anim < 1.0f) {
                 float radius = p.radius * (1.0f + anim * 3.0f);
                 float alpha = 1.0f - anim;
-                DrawCircleV(p.pos, radius, FadeColor(palette.bridge.inner, alpha * 0.5f));
-                DrawRing(p.pos, radius - 3.0f, radius, 0.0f, 360.0f, 32, FadeColor(palette.bridge.outer, alpha));
+                shapes.Circle(p.pos, radius, FadeColor(palette.bridge.inner, alpha * 0.5f));
+                shapes.Ring(p.pos, radius - 3.0f, radius, FadeColor(palette.bridge.outer, alpha));
             }
             continue;
         }
 
         // Pulsing glow effect
-        float pulse = 0.7f + 0.3f * sinf(p.pulsePhase);
-        float glowRadius = p.radius * (1.3f + 0.2f * sinf(p.pulsePhase * 0.5f));
+        float pulse = 0.7f + 0.3f * FastSin(p.pulsePhase);
+        float glowRadius = p.radius * (1.3f + 0.2f * FastSin(p.pulsePhase * 0.5f));
 
         // Outer glow
-        for (int i = 3; i >= 0; --i) {
+        for (int i = quality.Current().preyGlowLayers - 1; i >= 0; --i) {
             float layerRadius = glowRadius + i * 8.0f;
             float layerAlpha = 0.15f * (1.0f - i * 0.2f) * pulse;
-            DrawCircleV(p.pos, layerRadius, FadeColor(palette.bridge.outer, layerAlpha));
+            shapes.Circle(p.pos, layerRadius, FadeColor(palette.bridge.outer, layerAlpha));
         }
 
         // Inner orb
-        DrawCircleV(p.pos, p.radius, FadeColor(palette.bridge.inner, 0.9f * pulse));
-        DrawCircleV(p.pos, p.radius * 0.6f, FadeColor(RGB{255, 255, 255}, 0.7f * pulse));
+        shapes.Circle(p.pos, p.radius, FadeColor(palette.bridge.inner, 0.9f * pulse));
+        shapes.Circle(p.pos, p.radius * 0.6f, FadeColor(RGB{255, 255, 255}, 0.7f * pulse));
 
         // Sparkle
-        float sparkleAngle = time * 3.0f + p.pulsePhase;
+        float sparkleSin, sparkleCos;
+        SinCos(time * 3.0f + p.pulsePhase, sparkleSin, sparkleCos);
         Vector2 sparklePos = {
-            p.pos.x + cosf(sparkleAngle) * p.radius * 0.4f,
-            p.pos.y + sinf(sparkleAngle) * p.radius * 0.4f
+            p.pos.x + sparkleCos * p.radius * 0.4f,
+            p.pos.y + sparkleSin * p.radius * 0.4f
         };
-        DrawCircleV(sparklePos, 2.0f + sinf(time * 8.0f) * 1.0f, WHITE);
+        shapes.Circle(sparklePos, 2.0f + FastSin(time * 8.0f) * 1.0f, WHITE);
     }
+    shapes.Flush();
 }
 
 
 void Engine::drawWithBloom() {
-    // Render scene to texture
+    // The gradient only changes with the palette and window size, and stays
+    // out of the glow.
+    backdropLayer.Update({0.0f, 0.0f, static_cast<float>(screenWidth), static_cast<float>(screenHeight)}, paletteIndex,
+                         [&] { drawGradient(); });
+
+    // Render scene to texture, in window coordinates scaled to its size.
+    // (BeginMode2D would also apply the window's DPI scale.)
+    const float scale = static_cast<float>(sceneTexture.texture.width) / static_cast<float>(screenWidth);
     BeginTextureMode(sceneTexture);
-    ClearBackground(BLACK);
-    drawBackground();
+    ClearBackground(BLANK);
+    BeginCoverageBlend();
+    rlPushMatrix();
+    rlScalef(scale, scale, 1.0f);
+    drawStars();
     drawRipples();
     drawTrails();
     drawPrey();
     drawTentacles();
     drawEnergyBridge();
+    rlPopMatrix();
+    EndBlendMode();
     EndTextureMode();
 
-    // Extract bright areas to bloom texture (downsampled)
-    BeginTextureMode(bloomTexture);
-    ClearBackground(BLACK);
-    DrawTexturePro(
-        sceneTexture.texture,
-        {0, 0, static_cast<float>(sceneTexture.texture.width), -static_cast<float>(sceneTexture.texture.height)},
-        {0, 0, static_cast<float>(bloomTexture.texture.width), static_cast<float>(bloomTexture.texture.height)},
-        {0, 0}, 0.0f, WHITE
-    );
-    EndTextureMode();
-
-    // Horizontal blur pass
-    BeginTextureMode(blurTexture1);
-    ClearBackground(BLACK);
-    // Draw bloomTexture with slight offset multiple times for blur effect
-    for (int i = -3; i <= 3; ++i) {
-        float alpha = 0.15f * (1.0f - fabsf(i) * 0.12f);
-        DrawTexturePro(
-            bloomTexture.texture,
-            {0, 0, static_cast<float>(bloomTexture.texture.width), -static_cast<float>(bloomTexture.texture.height)},
-            {static_cast<float>(i * 2), 0, static_cast<float>(blurTexture1.texture.width), static_cast<float>(blurTexture1.texture.height)},
-            {0, 0}, 0.0f, Fade(WHITE, alpha)
-        );
-    }
-    EndTextureMode();
-
-    // Vertical blur pass
-    BeginTextureMode(blurTexture2);
-    ClearBackground(BLACK);
-    for (int i = -3; i <= 3; ++i) {
-        float alpha = 0.15f * (1.0f - fabsf(i) * 0.12f);
-        DrawTexturePro(
-            blurTexture1.texture,
-            {0, 0, static_cast<float>(blurTexture1.texture.width), -static_cast<float>(blurTexture1.texture.height)},
-            {0, static_cast<float>(i * 2), static_cast<float>(blurTexture2.texture.width), static_cast<float>(blurTexture2.texture.height)},
-            {0, 0}, 0.0f, Fade(WHITE, alpha)
-        );
-    }
-    EndTextureMode();
-
-    // Final composite: scene + bloom
-    // Draw original scene
-    DrawTexturePro(
-        sceneTexture.texture,
-        {0, 0, static_cast<float>(sceneTexture.texture.width), -static_cast<float>(sceneTexture.texture.height)},
-        {0, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)},
-        {0, 0}, 0.0f, WHITE
-    );
-
-    // Additive bloom overlay
-    BeginBlendMode(BLEND_ADDITIVE);
-    DrawTexturePro(
-        blurTexture2.texture,
-        {0, 0, static_cast<float>(blurTexture2.texture.width), -static_cast<float>(blurTexture2.texture.height)},
-        {0, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)},
-        {0, 0}, 0.0f, Fade(WHITE, 0.7f)
-    );
-    // Second pass for stronger glow
-    DrawTexturePro(
-        bloomTexture.texture,
-        {0, 0, static_cast<float>(bloomTexture.texture.width), -static_cast<float>(bloomTexture.texture.height)},
-        {0, 0, static_cast<float>(screenWidth), static_cast<float>(screenHeight)},
-        {0, 0}, 0.0f, Fade(WHITE, 0.35f)
-    );
-    EndBlendMode();
+    // Glow from the bright parts, added while laying the scene over the
+    // gradient.
+    bloom.Render(sceneTexture.texture);
+    bloom.Composite(sceneTexture.texture, backdropLayer.Texture(), static_cast<float>(screenWidth),
+                    static_cast<float>(screenHeight));
 
-    // HUD and timer on top (not bloomed)
+    // HUD and timer on top at full resolution (not bloomed)
     drawTimer();
     drawHud();
 }
 
 void Engine::Draw() {
+    // Blend the last two simulation steps and project only that state.
+    const float renderAlpha = sim.RenderAlpha();
+    const TentacleBank& tentacles = sim.Tentacles();
+    renderCorePos = Vector3Lerp(sim.PrevCorePos(), sim.GetCore().pos, renderAlpha);
+    renderTips.clear();
+    for (int i = 0; i < tentacles.Count(); ++i) {
+        renderTips.push_back(tentacles.RenderTip(i, renderAlpha));
+    }
+    tentacles.CollectChains(renderCorePos, renderAlpha, chains);
+
     if (bloomInitialized) {
         drawWithBloom();
     } else {
-        drawBackground();
+        drawGradient();
+        drawStars();
         drawRipples();
         drawTrails();
         drawPrey();
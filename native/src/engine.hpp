@@ -1,11 +1,20 @@
 #pragma once
 
+#include "bloom.hpp"
+#include "bridge_renderer.hpp"
+#include "cached_layer.hpp"
+#include "quality_governor.hpp"
+#include "resolution_scaler.hpp"
+#include "shape_batch.hpp"
+#include "simulation.hpp"
+#include "tentacle_mesh.hpp"
+
 #include <raylib.h>
 
 #include <algorithm>
 #include <array>
 #include <cmath>
-#include <string>
+#include <cstdint>
 #include <vector>
 
 struct RGB {
@@ -14,7 +23,7 @@ struct RGB {
     int b{255};
     int a{255};
 
-    Color ToColor(float alpha = 1.0f) const {
+    constexpr Color ToColor(float alpha = 1.0f) const {
         const int aChannel = static_cast<int>((alpha * a));
         return {
             static_cast<unsigned char>(std::clamp(r, 0, 255)),
@@ -26,7 +35,7 @@ struct RGB {
 };
 
 struct Palette {
-    std::string name;
+    const char* name;
     RGB tentacle;
     RGB glow;
     struct Orb {
@@ -47,207 +56,129 @@ struct Palette {
     RGB ripple;
 };
 
-struct BackgroundParticle {
-    Vector2 pos{};
-    Vector2 drift{};
-    float depth{};
-    float size{};
-    float twinkle{};
-};
-
-struct Ripple {
-    Vector2 pos{};
-    double start{0.0};
-    double lifespan{0.9};
-};
-
-struct TrailParticle {
-    Vector2 pos{};
-    Vector2 vel{};
-    float alpha{1.0f};
-    float size{3.0f};
-    float lifetime{0.0f};
-    float maxLife{0.5f};
-};
-
-struct Prey {
-    Vector2 pos{};
-    float radius{18.0f};
-    float pulsePhase{0.0f};
-    bool captured{false};
-    float captureAnim{0.0f};
-    float spawnDelay{0.0f};
-};
-
-
-struct AnchorRing {
-    float offset{0.0f};
-    float angularVelocity{0.0f};
-    float friction{0.9f};
-    float maxAV{6.0f};
-};
-
-struct Core {
-    Vector3 pos{0.0f, 0.0f, 0.0f};
-    Vector2 vel{0.0f, 0.0f};
-    float radius{50.0f};
-    float vx{0.0f};
-    float vy{0.0f};
-    float avAccum{0.0f};
-    int avCount{0};
-};
-
-struct EnergyParticle {
-    int tipIndex{0};
-    float t{0.0f};
-    float speed{1.0f};
-};
-
-struct EnergyBridge {
-    bool isActive{false};
-    bool pending{false};
-    float progress{0.0f};
-    double startTime{0.0};
-    double lastTrigger{-1e9};
-    float duration{3.0f};
-    float cooldown{3.5f};
-    float spawnAccumulator{0.0f};
-    std::vector<EnergyParticle> particles;
-};
-
-struct TentacleSegment {
-    Vector3 pos{};
-    Vector3 prev{};
-    float offset{0.0f};
-};
-
-struct SegmentDraw {
-    Vector2 a{};
-    Vector2 b{};
-    float avgZ{0.0f};
-    float width{1.0f};
+// raylib-backed implementations of the simulation's host interfaces.
+class RaylibClock : public SimClock {
+public:
+    double Seconds() override;
 };
 
-class Tentacle {
+class RaylibInput : public SimInputSource {
 public:
-    Tentacle(Core& core, float baseAngle, float attachRadius);
-
-    void Update(float dt, double timeMs, bool isActive, AnchorRing& ring, const std::vector<Tentacle>& neighbors);
-    void CollectSegments(const Core& core, std::vector<SegmentDraw>& back, std::vector<SegmentDraw>& front) const;
-    const Vector3& Tip() const;
-    float AnchorAngle() const { return anchorAngle; }
-
-private:
-    Core& core;
-    float baseAngle{};
-    float attachRadius{};
-    std::vector<TentacleSegment> segments;
-    int iterations{4};
-    float airDamping{0.995f};
-    float bendStiffness{0.08f};
-    float collisionPad{2.5f};
-    float waveAmpIdle{0.18f};
-    float waveAmpActive{0.33f};
-    float waveSpeedIdle{2.0f};
-    float waveSpeedActive{4.8f};
-    float wavePhaseOffset{0.45f};
-    float zBias{0.4f};
-    float frictionStrength{0.15f};
-    float segmentLength{10.0f};
-    float length{30.0f};
-    float anchorAngle{0.0f};
-    float anchorAV{0.0f};
-    float anchorFriction{0.9f};
-    float anchorCoreInfluence{0.6f};
-    float anchorTensionInfluence{0.15f};
-    float anchorMaxAV{6.0f};
-    float animationSeed{0.0f};
-    float lastAttachX{0.0f};
-    float lastAttachY{0.0f};
-    float lastAttachZ{0.0f};
-    float coreTangentialVelocity{0.0f};
-
+    SimInput Poll() override;
 };
 
 class Engine {
 public:
-    Engine(int width, int height);
+    // seed 0 picks a random seed.
+    Engine(int width, int height, std::uint64_t seed = 0);
     ~Engine();
 
-    void Update(float dt);
+    // Advances the simulation by the wall time since the last call in fixed
+    // steps; Draw() then blends the last two steps.
+    void Update();
     void Draw();
+    void SetSimulationRate(float hz);
+    // Forces the tentacle kernels' instruction set (see TentacleBank).
+    void SetSimdIsa(SimdIsa isa);
+    void SetBloomSettings(const BloomSettings& settings);
+    // Frame rate the render scale and quality tier adapt to hold; 0
+    // (uncapped) holds 60.
+    void SetTargetFps(int fps);
+    // Renders the scene at scale times the window size instead of adapting.
+    void SetRenderScale(float scale);
+    // Holds one of QualityGovernor's tiers instead of adapting.
+    void SetQualityTier(int tier);
 
 private:
+    // What the cached HUD, timer and game over layers show; a layer is
+    // redrawn when its state changes.
+    struct HudState {
+        static constexpr int BRIDGE_READY = -1;
+        static constexpr int BRIDGE_ACTIVE = -2;
+        int palette{0};
+        int score{0};
+        // BRIDGE_READY, BRIDGE_ACTIVE or tenths of a second of recharge left.
+        int bridge{BRIDGE_READY};
+        // SimdIsa of the solver, or -1 for the reference path.
+        int solver{-1};
+        bool operator==(const HudState&) const = default;
+    };
+    struct TimerState {
+        int palette{0};
+        int tenths{0};
+        // Pixels of the bar filled.
+        int fill{0};
+        bool low{false};
+        bool operator==(const TimerState&) const = default;
+    };
+    struct GameOverState {
+        int palette{0};
+        int score{0};
+        int highScore{0};
+        bool operator==(const GameOverState&) const = default;
+    };
+
     void handleInput();
-    void updateCore(float dt);
-    void rebuildBackground(int width, int height);
-    void updateBackground(float dt);
-    void drawBackground() const;
-    void drawRipples() const;
-    void drawCore() const;
+    void drawGradient() const;
+    void drawStars();
+    void drawRipples();
+    void drawCore();
     void drawTentacles();
     void drawEnergyBridge();
-    void drawHud() const;
-    void addRipple(Vector2 pos);
-    void updateRipples();
-    void updateEnergyBridge(float dt);
-    void maybeActivateEnergyBridge();
+    void drawHud();
+    void drawHudPanel(const HudState& state) const;
     void cyclePalette(int direction);
-
-    // New systems
-    void updateTrails(float dt);
-    void drawTrails() const;
-    void updatePrey(float dt);
-    void drawPrey() const;
-    void spawnPrey();
-    void updateTimer(float dt);
-    void drawTimer() const;
-    void resetGame();
+    void drawTrails();
+    void drawPrey();
+    void drawTimer();
+    void drawTimerBar(const TimerState& state, float barX) const;
+    void drawGameOverBox(const GameOverState& scores, float boxX, float boxY) const;
     void initBloom();
     void resizeBloom(int width, int height);
+    void loadSceneTexture();
+    void applyQuality();
     void drawWithBloom();
 
-    Palette& currentPalette();
     const Palette& currentPalette() const;
 
     int screenWidth{};
     int screenHeight{};
-    Vector2 mousePos{};
-    bool mouseDown{false};
     bool hudVisible{true};
-    double nowMs{0.0};
-
-    Core core;
-    AnchorRing ring;
-    std::vector<Tentacle> tentacles;
-    EnergyBridge bridge;
-    std::vector<BackgroundParticle> background;
-    std::vector<Ripple> ripples;
-    std::vector<SegmentDraw> backSegments;
-    std::vector<SegmentDraw> frontSegments;
-    std::vector<Vector3> tipCache;
-
-    // Trail particles
-    std::vector<TrailParticle> trails;
-
-    // Prey system
-    std::vector<Prey> prey;
-    int score{0};
-    int maxPrey{8};
-
-    // Timer system
-    float gameTimer{60.0f};
-    float maxTime{60.0f};
-    bool gameOver{false};
-    int highScore{0};
-
-    // Bloom render textures
+
+    RaylibClock clock;
+    RaylibInput input;
+    Simulation sim;
+
+    Vector3 renderCorePos{};
+    std::vector<Vector3> renderTips;
+    ChainDrawBatch chains;
+    TentacleMesh tentacleMesh;
+    // Every tip's position on screen, for the bridge.
+    std::vector<Vector2> bridgeTips;
+    BridgeRenderer bridgeRenderer;
+    ShapeBatch shapes;
+
+    // The scene renders here first so Bloom can glow it; without bloom
+    // shaders it draws straight to the window. The texture is the window's
+    // size times the render scale, and the composite stretches it back up.
     RenderTexture2D sceneTexture{};
-    RenderTexture2D bloomTexture{};
-    RenderTexture2D blurTexture1{};
-    RenderTexture2D blurTexture2{};
+    ResolutionScaler resolution;
+    Bloom bloom;
     bool bloomInitialized{false};
+    // What the user asked for; the quality tier may cap the radius.
+    BloomSettings bloomSettings;
+
+    // Cuts effects, mainly the simulation's, to hold the frame rate.
+    QualityGovernor quality;
+    // Time the last Update spent in the simulation, for the two controllers.
+    float simSeconds{0.0f};
+
+    // Parts of the frame that change rarely, each kept in its own texture.
+    // The backdrop is the gradient behind the bloomed scene.
+    CachedLayer<int> backdropLayer;
+    CachedLayer<HudState> hudLayer;
+    CachedLayer<TimerState> timerLayer;
+    CachedLayer<GameOverState> gameOverLayer;
 
-    std::array<Palette, 3> palettes;
     int paletteIndex{0};
 };
@@ -0,0 +1,111 @@
+#pragma once
+
+// Approximate math for the per-segment hot paths, written once over the lane
+// types in simd.hpp. Everything here is built from the same vocabulary ops on
+// every lane type, so F32x1 gives bit-for-bit the results of the wider types
+// and the scalar solver can keep agreeing with the kernels.
+//
+// Error bounds (abyssal_math_bench measures them against libm):
+//   SinCos  absolute error under 1e-7 for |x| <= 8192; past that the
+//           argument reduction loses bits, as the float argument already has.
+//   Rsqrt   relative error under 3e-7 for normal positive inputs. The
+//           estimate comes from the CPU, so the last bits may differ between
+//           vendors (but not between lane widths on one machine).
+//   Phasor  error grows by a few 1e-8 per Advance(), under 2e-6 after the
+//           MAX_CHAIN_SEGMENTS steps a chain's wave takes.
+
+#include "simd.hpp"
+
+inline namespace ABYSSAL_ISA_NAMESPACE {
+
+// Round to nearest (ties to even) for |x| < 2^22. Adding and removing
+// 1.5 * 2^23 pushes the fraction out of the mantissa; it needs IEEE single
+// arithmetic without reassociation, which the build already relies on.
+template <class V>
+inline V RoundNearest(V x) {
+    const V magic = V::Set(12582912.0f);
+    return (x + magic) - magic;
+}
+
+// sin(x) and cos(x) together. x is reduced to r in [-pi/4, pi/4] with a
+// three-part pi/2 (Cody-Waite), then the Cephes single-precision minimax
+// polynomials give sin r and cos r; the quadrant swaps and negates them.
+template <class V>
+inline void SinCos(V x, V& sinOut, V& cosOut) {
+    const V zero = V::Set(0.0f);
+    const V q = RoundNearest(x * V::Set(0.636619772f));
+    V r = x - q * V::Set(1.5703125f);
+    r = r - q * V::Set(4.83751296997e-4f);
+    r = r - q * V::Set(7.54978995489e-8f);
+    const V r2 = r * r;
+
+    V sinR = V::Set(-1.9515295891e-4f);
+    sinR = sinR * r2 + V::Set(8.3321608736e-3f);
+    sinR = sinR * r2 + V::Set(-1.6666654611e-1f);
+    sinR = sinR * r2 * r + r;
+    V cosR = V::Set(2.443315711809948e-5f);
+    cosR = cosR * r2 + V::Set(-1.388731625493765e-3f);
+    cosR = cosR * r2 + V::Set(4.166664568298827e-2f);
+    cosR = cosR * r2 * r2 - r2 * V::Set(0.5f) + V::Set(1.0f);
+
+    // Quadrant m = q mod 4, exact while q fits the mantissa.
+    const V m = q - RoundNearest(q * V::Set(0.25f) - V::Set(0.375f)) * V::Set(4.0f);
+    const auto odd = (m != zero) & (m != V::Set(2.0f));
+    const V s = Select(odd, cosR, sinR);
+    const V c = Select(odd, sinR, cosR);
+    sinOut = Select(m >= V::Set(2.0f), zero - s, s);
+    cosOut = Select((m != zero) & (m != V::Set(3.0f)), zero - c, c);
+}
+
+// 1 / sqrt(x) for x > 0: the hardware estimate plus one Newton-Raphson step.
+template <class V>
+inline V Rsqrt(V x) {
+    const V y = RsqrtEstimate(x);
+    return y * (V::Set(1.5f) - V::Set(0.5f) * x * y * y);
+}
+
+inline void SinCos(float x, float& sinOut, float& cosOut) {
+    F32x1 s, c;
+    SinCos(F32x1::Set(x), s, c);
+    sinOut = s.v;
+    cosOut = c.v;
+}
+
+inline float FastSin(float x) {
+    float s, c;
+    SinCos(x, s, c);
+    return s;
+}
+
+inline float FastCos(float x) {
+    float s, c;
+    SinCos(x, s, c);
+    return c;
+}
+
+inline float Rsqrt(float x) {
+    return Rsqrt(F32x1::Set(x)).v;
+}
+
+// sin and cos of an angle that moves by a fixed step, e.g. a travelling wave
+// sampled along a chain. Each Advance() is one complex multiply instead of a
+// fresh polynomial evaluation.
+template <class V>
+struct Phasor {
+    V sin;
+    V cos;
+
+    static Phasor Start(V angle) {
+        Phasor p;
+        SinCos(angle, p.sin, p.cos);
+        return p;
+    }
+
+    // Rotates by the step whose sine and cosine are given.
+    void Advance(V stepSin, V stepCos) {
+        const V s = sin * stepCos + cos * stepSin;
+        cos = cos * stepCos - sin * stepSin;
+        sin = s;
+    }
+};
+}
@@ -0,0 +1,205 @@
+// Steps the simulation without a window for benchmarks and soak runs.
+//
+//   abyssal_headless [--ticks N] [--hz N] [--tentacles N] [--threads N]
+//                    [--seed N] [--scalar] [--lod-tier N] [--segment-budget N]
+//                    [--idle] [--xpbd] [--direct] [--passes N] [--species N]
+//                    [--simd scalar|sse2|avx2|avx512]
+//
+// Input is scripted: the pointer orbits the screen centre, the button is held
+// for three seconds out of every four and the bridge fires every five seconds,
+// so runs with the same options and seed are reproducible. --idle sends no
+// input at all, like an unattended display. --xpbd solves the tentacles with
+// compliant XPBD constraints instead of the tuned PBD gains. --direct solves
+// each chain's distance constraints exactly every pass and --passes fixes the
+// pass count; together with the stretch error printed at the end they
+// compare inextensibility against cost. --species splits the tentacles
+// evenly over up to three archetypes: the default, short stiff darters and
+// long loose trailers. --simd forces the kernels' instruction set (as does
+// the ABYSSAL_SIMD environment variable); one the CPU lacks falls back to the
+// widest it has.
+
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace {
+class ScriptedInput : public SimInputSource {
+public:
+    ScriptedInput(float width, float height, float stepSeconds, bool idle)
+        : centerX(width * 0.5f), centerY(height * 0.5f), radius(std::fmin(width, height) * 0.3f),
+          stepSeconds(stepSeconds), idle(idle) {}
+
+    SimInput Poll() override {
+        if (idle) return {};
+        const float t = static_cast<float>(tick) * stepSeconds;
+        const bool down = std::fmod(t, 4.0f) < 3.0f;
+        SimInput in;
+        in.mousePos = {centerX + std::cos(t * 0.9f) * radius, centerY + std::sin(t * 1.3f) * radius};
+        in.mousePressed = down && !wasDown;
+        in.mouseReleased = !down && wasDown;
+        in.bridgeRequested = tick > 0 && tick % std::max(1L, std::lround(5.0f / stepSeconds)) == 0;
+        wasDown = down;
+        ++tick;
+        return in;
+    }
+
+private:
+    float centerX;
+    float centerY;
+    float radius;
+    float stepSeconds;
+    bool idle;
+    long tick{0};
+    bool wasDown{false};
+};
+
+std::vector<TentacleGroup> SpeciesGroups(int species, int tentacles) {
+    TentacleArchetype darter;
+    darter.segments = 16;
+    darter.segmentLength = 11.0f;
+    darter.bendStiffness = 0.12f;
+    darter.waveSpeedIdle = 3.0f;
+    darter.waveSpeedActive = 6.5f;
+    TentacleArchetype trailer;
+    trailer.segments = 40;
+    trailer.segmentLength = 8.0f;
+    trailer.bendStiffness = 0.05f;
+    trailer.airDamping = 0.997f;
+    const TentacleArchetype presets[] = {TentacleArchetype{}, darter, trailer};
+
+    species = std::clamp(species, 1, 3);
+    std::vector<TentacleGroup> groups;
+    for (int i = 0; i < species; ++i) {
+        groups.push_back({presets[i], tentacles * (i + 1) / species - tentacles * i / species});
+    }
+    return groups;
+}
+
+void PrintUsage() {
+    std::puts("usage: abyssal_headless [--ticks N] [--hz N] [--tentacles N] [--threads N] [--seed N] [--scalar]\n"
+              "                        [--lod-tier N] [--segment-budget N] [--idle] [--xpbd] [--direct] [--passes N]\n"
+              "                        [--species N] [--simd scalar|sse2|avx2|avx512]");
+}
+}
+
+int main(int argc, char** argv) {
+    long ticks = 600;
+    float hz = 60.0f;
+    bool scalar = false;
+    bool idle = false;
+    bool xpbd = false;
+    bool direct = false;
+    int passes = 0;
+    int species = 1;
+    bool forceIsa = false;
+    SimdIsa isa = SimdIsa::Scalar;
+    int lodTier = -1;
+    int segmentBudget = 0;
+    SimConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) {
+            ticks = std::atol(argv[++i]);
+        } else if (std::strcmp(argv[i], "--hz") == 0 && hasValue) {
+            hz = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--tentacles") == 0 && hasValue) {
+            config.tentacles = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+            config.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--lod-tier") == 0 && hasValue) {
+            lodTier = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--segment-budget") == 0 && hasValue) {
+            segmentBudget = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--scalar") == 0) {
+            scalar = true;
+        } else if (std::strcmp(argv[i], "--idle") == 0) {
+            idle = true;
+        } else if (std::strcmp(argv[i], "--xpbd") == 0) {
+            xpbd = true;
+        } else if (std::strcmp(argv[i], "--direct") == 0) {
+            direct = true;
+        } else if (std::strcmp(argv[i], "--passes") == 0 && hasValue) {
+            passes = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--species") == 0 && hasValue) {
+            species = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--simd") == 0 && hasValue && ParseSimdIsa(argv[i + 1], isa)) {
+            forceIsa = true;
+            ++i;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    config.stepHz = hz;
+    if (species > 1) config.tentacleGroups = SpeciesGroups(species, config.tentacles);
+
+    Simulation sim(config);
+    if (scalar) sim.Tentacles().SetSolverPath(SolverPath::Scalar);
+    if (forceIsa) sim.Tentacles().SetSimdIsa(isa);
+    if (xpbd) sim.Tentacles().SetConstraintModel(ConstraintModel::Xpbd);
+    if (direct) sim.Tentacles().SetDistanceSolver(DistanceSolver::Direct);
+    if (passes > 0) sim.Tentacles().SetIterationRange(passes, passes);
+    LodSettings lod = sim.Tentacles().GetLod();
+    lod.forcedTier = lodTier;
+    lod.segmentBudget = segmentBudget;
+    sim.Tentacles().SetLod(lod);
+    const float dt = sim.StepSeconds();
+    ScriptedInput input(static_cast<float>(config.width), static_cast<float>(config.height), dt, idle);
+
+    // Constraint passes over the run: mean per tentacle step and the range
+    // any block used. Stretch is each chain's mean relative segment error
+    // after the step, averaged over tentacles and steps, and the worst chain.
+    // The sleep share is the fraction of tentacle steps held instead of solved.
+    double ms = 0.0;
+    double passSum = 0.0;
+    int passMin = 0;
+    int passMax = 0;
+    float residualMax = 0.0f;
+    double stretchSum = 0.0;
+    float stretchMax = 0.0f;
+    double sleepSum = 0.0;
+    const TentacleBank& bank = sim.Tentacles();
+    for (long i = 0; i < ticks; ++i) {
+        sim.ApplyInput(input.Poll());
+        const auto start = std::chrono::steady_clock::now();
+        sim.Step(dt);
+        ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        for (int t = 0; t < bank.Count(); ++t) {
+            stretchSum += bank.StretchError(t);
+            stretchMax = std::max(stretchMax, bank.StretchError(t));
+        }
+        sleepSum += bank.SleepingCount();
+        const SolverStats& stats = bank.GetSolverStats();
+        passSum += stats.meanPasses;
+        passMin = i == 0 ? stats.minPasses : std::min(passMin, stats.minPasses);
+        passMax = std::max(passMax, stats.maxPasses);
+        residualMax = std::max(residualMax, stats.maxResidual);
+    }
+
+    double checksum = 0.0;
+    for (const Vector3& tip : sim.Tips()) {
+        checksum += tip.x + tip.y + tip.z;
+    }
+
+    std::printf("ticks %ld at %.0f Hz, %d tentacles of %d species, %s path (%s, %d lanes), %s constraints, %s distances\n",
+                ticks, 1.0f / dt, bank.Count(), bank.ArchetypeCount(), scalar ? "scalar" : "simd",
+                scalar ? "reference" : SimdIsaName(bank.GetSimdIsa()), scalar ? 1 : bank.SimdWidth(),
+                xpbd ? "xpbd" : "pbd", direct ? "direct" : "gauss-seidel");
+    std::printf("total %.2f ms, %.4f ms/tick\n", ms, ticks > 0 ? ms / static_cast<double>(ticks) : 0.0);
+    const double samples = static_cast<double>(ticks) * bank.Count();
+    std::printf("segments %d of %d, %d tentacles asleep (%.1f%% of tentacle steps)\n", bank.ActiveSegments(),
+                bank.FullDetailSegments(), bank.SleepingCount(), samples > 0.0 ? 100.0 * sleepSum / samples : 0.0);
+    std::printf("passes %.2f per step (%d-%d), worst residual %.3f\n",
+                ticks > 0 ? passSum / static_cast<double>(ticks) : 0.0, passMin, passMax, residualMax);
+    std::printf("stretch %.4f mean, %.4f worst\n", samples > 0.0 ? stretchSum / samples : 0.0, stretchMax);
+    std::printf("score %d, tip checksum %.6f\n", sim.Score(), checksum);
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+
+namespace {
+thread_local const JobSystem* tlsOwner = nullptr;
+thread_local unsigned tlsSlot = 0;
+}
+
+void TaskGroup::Run(std::function<void()> fn) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    jobs.push({std::move(fn), this});
+}
+
+void TaskGroup::Wait() {
+    const unsigned self = jobs.currentSlot();
+    while (pending.load(std::memory_order_acquire) > 0) {
+        if (!jobs.tryRunOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+JobSystem::JobSystem(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    queues.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    tlsOwner = this;
+    tlsSlot = 0;
+    workers.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; ++i) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true);
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned JobSystem::currentSlot() const {
+    return tlsOwner == this ? tlsSlot : 0;
+}
+
+void JobSystem::push(Task task) {
+    Queue& q = *queues[currentSlot()];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1, std::memory_order_release);
+    // Taking the lock orders this push against a worker that is about to
+    // sleep, so the notification cannot be lost.
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    wake.notify_one();
+}
+
+bool JobSystem::popLocal(unsigned self, Task& out) {
+    Queue& q = *queues[self];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.tasks.empty()) return false;
+    out = std::move(q.tasks.back());
+    q.tasks.pop_back();
+    return true;
+}
+
+bool JobSystem::steal(unsigned self, Task& out) {
+    const unsigned n = ThreadCount();
+    for (unsigned k = 1; k < n; ++k) {
+        Queue& q = *queues[(self + k) % n];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) continue;
+        out = std::move(q.tasks.front());
+        q.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::tryRunOne(unsigned self) {
+    Task task;
+    if (!popLocal(self, task) && !steal(self, task)) return false;
+    queued.fetch_sub(1, std::memory_order_relaxed);
+    task.fn();
+    if (task.group) {
+        task.group->pending.fetch_sub(1, std::memory_order_release);
+    }
+    return true;
+}
+
+void JobSystem::workerLoop(unsigned index) {
+    tlsOwner = this;
+    tlsSlot = index;
+    while (true) {
+        if (tryRunOne(index)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping.load() || queued.load(std::memory_order_acquire) > 0; });
+        if (stopping.load()) return;
+    }
+}
+
+void JobSystem::ParallelFor(int count, int grain, const std::function<void(int, int)>& fn) {
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+    if (ThreadCount() == 1 || count <= grain) {
+        fn(0, count);
+        return;
+    }
+    TaskGroup group(*this);
+    // Keep the first chunk for this thread so it starts working immediately.
+    for (int begin = grain; begin < count; begin += grain) {
+        const int end = std::min(count, begin + grain);
+        group.Run([&fn, begin, end] { fn(begin, end); });
+    }
+    fn(0, std::min(count, grain));
+    group.Wait();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+// A set of tasks that can be waited on together. Wait() runs queued work on
+// the calling thread instead of blocking, so groups may be nested.
+class TaskGroup {
+public:
+    explicit TaskGroup(JobSystem& jobs) : jobs(jobs) {}
+    ~TaskGroup() { Wait(); }
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void Run(std::function<void()> fn);
+    void Wait();
+
+private:
+    friend class JobSystem;
+    JobSystem& jobs;
+    std::atomic<int> pending{0};
+};
+
+// Work-stealing thread pool. Every worker owns a deque: it pushes and pops
+// its own work at the back and steals from the front of the others. The
+// thread that owns the JobSystem uses slot 0 and takes part in the work
+// whenever it waits on a group.
+class JobSystem {
+public:
+    // threadCount includes the calling thread; 0 picks the hardware count.
+    explicit JobSystem(unsigned threadCount = 0);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned ThreadCount() const { return static_cast<unsigned>(queues.size()); }
+
+    // Calls fn(begin, end) over [0, count) in chunks of at most grain items
+    // and returns once every chunk has finished.
+    void ParallelFor(int count, int grain, const std::function<void(int, int)>& fn);
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group{nullptr};
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void push(Task task);
+    bool tryRunOne(unsigned self);
+    bool popLocal(unsigned self, Task& out);
+    bool steal(unsigned self, Task& out);
+    void workerLoop(unsigned index);
+    unsigned currentSlot() const;
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{0};
+    std::atomic<bool> stopping{false};
+};
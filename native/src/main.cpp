@@ -2,18 +2,56 @@
 
 #include <raylib.h>
 
+#include <cstdlib>
+#include <cstring>
+
 constexpr const char* APP_NAME = "Abyssal Tentacle (Native)";
 
-int main() {
+int main(int argc, char** argv) {
+    float simHz = 60.0f;
+    int targetFps = 60;
+    unsigned long long seed = 0;
+    bool forceIsa = false;
+    SimdIsa isa = SimdIsa::Scalar;
+    BloomSettings bloom;
+    float renderScale = 0.0f;
+    int qualityTier = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--sim-hz") == 0 && i + 1 < argc) {
+            simHz = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+            targetFps = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+            forceIsa = ParseSimdIsa(argv[++i], isa);
+        } else if (std::strcmp(argv[i], "--bloom-radius") == 0 && i + 1 < argc) {
+            bloom.radius = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--bloom-intensity") == 0 && i + 1 < argc) {
+            bloom.intensity = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--bloom-threshold") == 0 && i + 1 < argc) {
+            bloom.threshold = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--render-scale") == 0 && i + 1 < argc) {
+            renderScale = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--quality") == 0 && i + 1 < argc) {
+            qualityTier = std::atoi(argv[++i]);
+        }
+    }
+
     SetConfigFlags(FLAG_WINDOW_RESIZABLE | FLAG_MSAA_4X_HINT);
     InitWindow(1280, 720, APP_NAME);
-    SetTargetFPS(60);
+    SetTargetFPS(targetFps);
 
-    Engine engine(GetScreenWidth(), GetScreenHeight());
+    Engine engine(GetScreenWidth(), GetScreenHeight(), seed);
+    engine.SetSimulationRate(simHz);
+    if (forceIsa) engine.SetSimdIsa(isa);
+    engine.SetBloomSettings(bloom);
+    engine.SetTargetFps(targetFps);
+    if (renderScale > 0.0f) engine.SetRenderScale(renderScale);
+    if (qualityTier >= 0) engine.SetQualityTier(qualityTier);
 
     while (!WindowShouldClose()) {
-        float dt = GetFrameTime();
-        engine.Update(dt);
+        engine.Update();
 
         BeginDrawing();
         ClearBackground(BLACK);
@@ -0,0 +1,148 @@
+// Checks the approximations in fast_math.hpp against libm and times both.
+//
+//   abyssal_math_bench [--count N] [--rounds N]
+//
+// Errors are measured against double precision over the ranges the
+// simulation uses. Timings are the best of --rounds passes over --count
+// values, with the widest lane type the build allows for the fast versions.
+
+#include "fast_math.hpp"
+#include "tentacle_bank.hpp"
+#include "tentacle_kernels.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+using V = F32xN;
+
+template <typename Fn>
+double BestNsPerValue(int rounds, int count, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ns / count);
+    }
+    return best;
+}
+
+// Keeps the compiler from dropping a timed loop whose results are unused.
+float Sink(const AlignedVector<float>& values) {
+    float sum = 0.0f;
+    for (float v : values) sum += v;
+    return sum;
+}
+
+void PrintUsage() {
+    std::puts("usage: abyssal_math_bench [--count N] [--rounds N]");
+}
+}
+
+int main(int argc, char** argv) {
+    int count = 1 << 16;
+    int rounds = 20;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--count") == 0 && hasValue) {
+            count = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--rounds") == 0 && hasValue) {
+            rounds = std::atoi(argv[++i]);
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+    count = std::max(V::Width, count / V::Width * V::Width);
+    rounds = std::max(rounds, 1);
+
+    // Accuracy. sin/cos over the documented range, and over the wave phases
+    // a long run reaches; rsqrt over every binade of normal floats.
+    double sinErr = 0.0;
+    double cosErr = 0.0;
+    for (int i = 0; i <= 4000000; ++i) {
+        const float x = -8192.0f + 16384.0f * static_cast<float>(i) / 4000000.0f;
+        float s, c;
+        SinCos(x, s, c);
+        sinErr = std::max(sinErr, std::fabs(s - std::sin(static_cast<double>(x))));
+        cosErr = std::max(cosErr, std::fabs(c - std::cos(static_cast<double>(x))));
+    }
+    double rsqrtErr = 0.0;
+    for (int e = -125; e < 127; ++e) {
+        for (int i = 0; i < 4096; ++i) {
+            const float x = std::ldexp(1.0f + static_cast<float>(i) / 4096.0f, e);
+            const double exact = 1.0 / std::sqrt(static_cast<double>(x));
+            rsqrtErr = std::max(rsqrtErr, std::fabs(Rsqrt(x) - exact) / exact);
+        }
+    }
+    // A travelling wave along the longest chain, from an awkward start.
+    double phasorErr = 0.0;
+    {
+        const float start = 1234.567f;
+        const float step = -0.45f;
+        float stepSin, stepCos;
+        SinCos(step, stepSin, stepCos);
+        Phasor<F32x1> wave = Phasor<F32x1>::Start(F32x1::Set(start));
+        for (int i = 0; i < MAX_CHAIN_SEGMENTS; ++i) {
+            const double exact = std::sin(static_cast<double>(start) + static_cast<double>(step) * i);
+            phasorErr = std::max(phasorErr, std::fabs(wave.sin.v - exact));
+            wave.Advance(F32x1::Set(stepSin), F32x1::Set(stepCos));
+        }
+    }
+
+    // Speed.
+    AlignedVector<float> in(count);
+    AlignedVector<float> outA(count);
+    AlignedVector<float> outB(count);
+    for (int i = 0; i < count; ++i) {
+        in[i] = 0.001f + 100.0f * static_cast<float>(i) / static_cast<float>(count);
+    }
+    const double libmSinCos = BestNsPerValue(rounds, count, [&] {
+        for (int i = 0; i < count; ++i) {
+            outA[i] = sinf(in[i]);
+            outB[i] = cosf(in[i]);
+        }
+    });
+    const double fastSinCos = BestNsPerValue(rounds, count, [&] {
+        for (int i = 0; i < count; i += V::Width) {
+            V s, c;
+            SinCos(V::Load(in.data() + i), s, c);
+            s.Store(outA.data() + i);
+            c.Store(outB.data() + i);
+        }
+    });
+    const float stepSin = FastSin(0.01f);
+    const float stepCos = FastCos(0.01f);
+    const double phasorSinCos = BestNsPerValue(rounds, count, [&] {
+        // One lane-wide wave per Width values, advanced a step per group.
+        Phasor<V> wave = Phasor<V>::Start(V::Load(in.data()));
+        for (int i = 0; i < count; i += V::Width) {
+            wave.sin.Store(outA.data() + i);
+            wave.cos.Store(outB.data() + i);
+            wave.Advance(V::Set(stepSin), V::Set(stepCos));
+        }
+    });
+    const double libmRsqrt = BestNsPerValue(rounds, count, [&] {
+        for (int i = 0; i < count; i += V::Width) {
+            (V::Set(1.0f) / Sqrt(V::Load(in.data() + i))).Store(outA.data() + i);
+        }
+    });
+    const double fastRsqrt = BestNsPerValue(rounds, count, [&] {
+        for (int i = 0; i < count; i += V::Width) {
+            Rsqrt(V::Load(in.data() + i)).Store(outB.data() + i);
+        }
+    });
+
+    std::printf("%d values, best of %d, %d lanes\n", count, rounds, V::Width);
+    std::printf("sincos  libm %.3f ns, poly %.3f ns, phasor %.3f ns; error sin %.2e cos %.2e phasor %.2e\n",
+                libmSinCos, fastSinCos, phasorSinCos, sinErr, cosErr, phasorErr);
+    std::printf("rsqrt   1/sqrt %.3f ns, estimate+newton %.3f ns; relative error %.2e\n", libmRsqrt, fastRsqrt,
+                rsqrtErr);
+    std::printf("sink %.3f\n", Sink(outA) + Sink(outB));
+    return 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <raylib.h>
+#include <raymath.h>
+
+#include <cmath>
+
+constexpr float CAMERA_Z = 700.0f;
+constexpr float CAMERA_F = 600.0f;
+constexpr float PI2 = 2.0f * PI;
+
+struct ScreenPoint {
+    Vector2 pos;
+    float scale;
+    float z;
+};
+
+inline float ClampAngle(float angle) {
+    while (angle > PI) angle -= PI2;
+    while (angle < -PI) angle += PI2;
+    return angle;
+}
+
+inline ScreenPoint ProjectPoint(const Vector3& origin, const Vector3& point) {
+    float dx = point.x - origin.x;
+    float dy = point.y - origin.y;
+    float dz = point.z - origin.z;
+    float denom = fmaxf(0.001f, CAMERA_Z - dz);
+    float scale = CAMERA_F / denom;
+    return {{origin.x + dx * scale, origin.y + dy * scale}, scale, dz};
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+// Lane-parallel particle updates: trail particles and the prey hit test.
+// Like the chain kernels they are built once per SimdIsa (see
+// tentacle_kernels.cpp) and picked at run time with ParticleKernelsFor();
+// every build gives the same results. Arrays are structure-of-arrays and
+// 64-byte aligned; the last count % V::Width entries run on F32x1.
+
+#include "cpu_features.hpp"
+#include "simd.hpp"
+
+#include <cstddef>
+
+// One step of the trail particles, count of them.
+struct TrailBlock {
+    float* posX;
+    float* posY;
+    float* velX;
+    float* velY;
+    float* alpha;
+    float* size;
+    float* lifetime;
+    const float* maxLife;
+    std::size_t count;
+
+    float dt;
+    // Per-step size and velocity factors.
+    float shrink;
+    float slow;
+};
+
+struct ParticleKernels {
+    // Ages, fades, shrinks and moves every trail particle; dead ones are left
+    // for the caller to drop.
+    void (*advanceTrails)(const TrailBlock& b);
+    // Index of the first of count points within reach of (cx, cy), or -1.
+    int (*firstWithin)(const float* x, const float* y, std::size_t count, float cx, float cy, float reach);
+};
+
+// Kernels of the isa build. isa must be supported (IsSimdIsaSupported).
+ParticleKernels ParticleKernelsFor(SimdIsa isa);
+
+// The builds behind ParticleKernelsFor, built alongside the chain kernels.
+ParticleKernels ParticleKernelsScalar();
+ParticleKernels ParticleKernelsSse2();
+ParticleKernels ParticleKernelsAvx2();
+ParticleKernels ParticleKernelsAvx512();
+
+inline namespace ABYSSAL_ISA_NAMESPACE {
+template <class V>
+void AdvanceTrailsFrom(const TrailBlock& b, std::size_t begin, std::size_t end) {
+    const V dt = V::Set(b.dt);
+    const V shrink = V::Set(b.shrink);
+    const V slow = V::Set(b.slow);
+    const V fade = V::Set(0.8f);
+    const V one = V::Set(1.0f);
+    for (std::size_t i = begin; i < end; i += V::Width) {
+        const V lifetime = V::Load(b.lifetime + i) + dt;
+        const V vx = V::Load(b.velX + i);
+        const V vy = V::Load(b.velY + i);
+        lifetime.Store(b.lifetime + i);
+        (fade * (one - lifetime / V::Load(b.maxLife + i))).Store(b.alpha + i);
+        (V::Load(b.size + i) * shrink).Store(b.size + i);
+        (V::Load(b.posX + i) + vx * dt).Store(b.posX + i);
+        (V::Load(b.posY + i) + vy * dt).Store(b.posY + i);
+        (vx * slow).Store(b.velX + i);
+        (vy * slow).Store(b.velY + i);
+    }
+}
+
+template <class V>
+void AdvanceTrails(const TrailBlock& b) {
+    const std::size_t whole = b.count - b.count % V::Width;
+    AdvanceTrailsFrom<V>(b, 0, whole);
+    AdvanceTrailsFrom<F32x1>(b, whole, b.count);
+}
+
+template <class V>
+int FirstWithin(const float* x, const float* y, std::size_t count, float cx, float cy, float reach) {
+    const std::size_t whole = count - count % V::Width;
+    const V px = V::Set(cx), py = V::Set(cy), reach2 = V::Set(reach * reach);
+    for (std::size_t i = 0; i < whole; i += V::Width) {
+        const V dx = V::Load(x + i) - px;
+        const V dy = V::Load(y + i) - py;
+        if (!Any(dx * dx + dy * dy < reach2)) continue;
+        // Some lane hit; the first one is the answer.
+        for (std::size_t j = i; j < i + V::Width; ++j) {
+            const float ex = x[j] - cx;
+            const float ey = y[j] - cy;
+            if (ex * ex + ey * ey < reach * reach) return static_cast<int>(j);
+        }
+    }
+    for (std::size_t j = whole; j < count; ++j) {
+        const float ex = x[j] - cx;
+        const float ey = y[j] - cy;
+        if (ex * ex + ey * ey < reach * reach) return static_cast<int>(j);
+    }
+    return -1;
+}
+
+template <class V>
+constexpr ParticleKernels MakeParticleKernels() {
+    return {&AdvanceTrails<V>, &FirstWithin<V>};
+}
+}
@@ -0,0 +1,109 @@
+#include "quality_governor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// trails, trail spawn, star density, solver passes; bloom levels, prey rings
+constexpr QualityTier QUALITY_TIERS[] = {
+    {"high", {500, 1.0f, 1.0f, 0}, 8, 4},
+    {"medium", {300, 0.6f, 0.75f, 6}, 4, 3},
+    {"low", {150, 0.35f, 0.5f, 4}, 3, 2},
+    {"minimal", {60, 0.15f, 0.3f, 3}, 2, 1},
+};
+
+// A median above budget * SLOW, or a 95th percentile above budget * STUTTER,
+// misses the budget; a 95th percentile under budget * HEADROOM leaves room,
+// and one under budget * FITS keeps up.
+constexpr float SLOW = 1.08f;
+constexpr float STUTTER = 1.5f;
+constexpr float HEADROOM = 0.75f;
+constexpr float FITS = 1.1f;
+// Full windows that keep up before probing a tier better; each failed probe
+// doubles it, up to MAX_BACKOFF times, and each probe that holds halves it.
+constexpr int PROBE_RUNS = 5;
+constexpr int MAX_BACKOFF = 2;
+// Render-bound windows that must miss in a row before the tier drops for
+// them, leaving ResolutionScaler time to lower the scale first.
+constexpr int RENDER_PATIENCE = 3;
+}
+
+int QualityGovernor::TierCount() {
+    return static_cast<int>(std::size(QUALITY_TIERS));
+}
+
+const QualityTier& QualityGovernor::TierAt(int value) {
+    return QUALITY_TIERS[std::clamp(value, 0, TierCount() - 1)];
+}
+
+void QualityGovernor::SetBudget(float seconds) {
+    if (seconds > 0.0f) budget = seconds;
+}
+
+void QualityGovernor::Fix(int value) {
+    fixed = true;
+    tier = std::clamp(value, 0, TierCount() - 1);
+}
+
+float QualityGovernor::percentile(const std::array<float, WINDOW>& values, float p) {
+    sorted.assign(values.begin(), values.begin() + frameCount);
+    const int rank = std::clamp(static_cast<int>(std::ceil(p * frameCount)) - 1, 0, frameCount - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
+
+bool QualityGovernor::Update(float frameSeconds, float simSeconds) {
+    if (fixed || frameSeconds <= 0.0f) return false;
+    frames[nextFrame] = frameSeconds;
+    simFrames[nextFrame] = std::clamp(simSeconds, 0.0f, frameSeconds);
+    nextFrame = (nextFrame + 1) % WINDOW;
+    frameCount = std::min(frameCount + 1, WINDOW);
+    // Judge whole windows only, so the percentiles cover WINDOW frames
+    // since the last change.
+    if (frameCount < WINDOW || nextFrame != 0) return false;
+
+    median = percentile(frames, 0.5f);
+    slowest = percentile(frames, 0.95f);
+    simMedian = percentile(simFrames, 0.5f);
+    if (median > budget * SLOW || slowest > budget * STUTTER) {
+        fitRuns = 0;
+        const bool failedProbe = probing;
+        if (probing) probeBackoff = std::min(probeBackoff + 1, MAX_BACKOFF);
+        probing = false;
+        const bool simBound = simMedian > median - simMedian;
+        if (!simBound && !failedProbe && ++renderMisses < RENDER_PATIENCE) return false;
+        renderMisses = 0;
+        return change(tier + 1);
+    }
+    renderMisses = 0;
+
+    if (probing) {
+        probing = false;
+        probeBackoff = std::max(probeBackoff - 1, 0);
+    }
+    if (slowest > budget * FITS) {
+        fitRuns = 0;
+        return false;
+    }
+    ++fitRuns;
+    if (tier == 0) return false;
+    if (slowest < budget * HEADROOM) {
+        probeBackoff = 0;
+        return change(tier - 1);
+    }
+    if (fitRuns >= PROBE_RUNS << probeBackoff) {
+        probing = true;
+        return change(tier - 1);
+    }
+    return false;
+}
+
+bool QualityGovernor::change(int next) {
+    next = std::clamp(next, 0, TierCount() - 1);
+    fitRuns = 0;
+    frameCount = 0;
+    nextFrame = 0;
+    if (next == tier) return false;
+    tier = next;
+    return true;
+}
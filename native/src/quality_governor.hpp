@@ -0,0 +1,78 @@
+#pragma once
+
+#include "simulation.hpp"
+
+#include <array>
+#include <vector>
+
+// One step of the quality ladder: what the simulation spends on effects and
+// the solver, and how much the renderer glows and layers.
+struct QualityTier {
+    const char* name;
+    SimQuality sim;
+    // Most blur levels the bloom may use, whatever its settings ask for.
+    int bloomRadius;
+    // Glow rings drawn around each prey orb.
+    int preyGlowLayers;
+};
+
+// Steps through QUALITY_TIERS, best first, to keep frames inside a budget.
+// It judges percentiles of the last WINDOW frame times rather than an
+// average, so a steady run of stutters counts even when most frames fit.
+//
+// A window misses the budget when its median does or its slowest frames miss
+// it badly. Each frame comes with the part the simulation took, so the
+// governor knows what the miss is spent on. A tier is dropped at once for a
+// miss the simulation dominates (its trails, stars and solver passes are
+// what a tier cuts) and for a failed probe. A miss that rendering dominates
+// is left to ResolutionScaler first; the tier drops for it only once it has
+// lasted RENDER_PATIENCE windows, for the bloom and glow a tier trims. With
+// clear headroom it climbs back one tier; at a frame cap, where a frame that
+// fits shows no headroom, it only probes a tier up after a long run at
+// budget, and waits twice as long after each probe that is dropped again.
+// Every change restarts the window.
+class QualityGovernor {
+public:
+    static constexpr int WINDOW = 120;
+
+    static int TierCount();
+    static const QualityTier& TierAt(int tier);
+
+    // Seconds per frame to hold.
+    void SetBudget(float seconds);
+    // Holds tier from now on instead of adapting.
+    void Fix(int tier);
+
+    // Feeds one frame's duration and the part of it the simulation took.
+    // True when Tier() changed.
+    bool Update(float frameSeconds, float simSeconds);
+    int Tier() const { return tier; }
+    const QualityTier& Current() const { return TierAt(tier); }
+    // Median and 95th percentile frame time, and median simulation time, of
+    // the last window judged, in seconds.
+    float Median() const { return median; }
+    float Slowest() const { return slowest; }
+    float SimMedian() const { return simMedian; }
+
+private:
+    float percentile(const std::array<float, WINDOW>& values, float p);
+    bool change(int next);
+
+    float budget{1.0f / 60.0f};
+    int tier{0};
+    bool fixed{false};
+
+    std::array<float, WINDOW> frames{};
+    std::array<float, WINDOW> simFrames{};
+    int frameCount{0};
+    int nextFrame{0};
+    int fitRuns{0};
+    int probeBackoff{0};
+    bool probing{false};
+    // Render-bound windows missed in a row.
+    int renderMisses{0};
+    float median{0.0f};
+    float slowest{0.0f};
+    float simMedian{0.0f};
+    std::vector<float> sorted;
+};
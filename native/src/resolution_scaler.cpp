@@ -0,0 +1,93 @@
+#include "resolution_scaler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Weight of the newest frame in the running average.
+constexpr float SMOOTHING = 0.1f;
+// Averages above budget * SLOW miss it; below budget * HEADROOM leave room.
+constexpr float SLOW = 1.08f;
+constexpr float HEADROOM = 0.8f;
+// Frames the average must stay slow, or have headroom, before acting.
+constexpr int SLOW_RUN = 20;
+constexpr int HEADROOM_RUN = 60;
+// Frames at budget before probing a step up. Each failed probe doubles the
+// wait, up to MAX_BACKOFF times, and each probe that holds halves it again.
+constexpr int PROBE_RUN = 180;
+constexpr int MAX_BACKOFF = 3;
+// Frames ignored after a change while the new target is allocated and the
+// average catches up.
+constexpr int SETTLE_RUN = 30;
+constexpr float MAX_DROP = 0.25f;
+}
+
+void ResolutionScaler::SetBudget(float seconds) {
+    if (seconds > 0.0f) budget = seconds;
+}
+
+void ResolutionScaler::Fix(float value) {
+    fixed = true;
+    scale = std::clamp(std::round(value / STEP) * STEP, MIN_SCALE, 1.0f);
+}
+
+bool ResolutionScaler::Update(float frameSeconds, float simSeconds) {
+    if (fixed || frameSeconds <= 0.0f) return false;
+    // A single hitch (a dragged window, a stall loading a texture) should
+    // not cost a quarter of the resolution.
+    frameSeconds = std::min(frameSeconds, budget * 4.0f);
+    simSeconds = std::clamp(simSeconds, 0.0f, frameSeconds);
+    const bool first = average <= 0.0f;
+    average = first ? frameSeconds : average + (frameSeconds - average) * SMOOTHING;
+    simAverage = first ? simSeconds : simAverage + (simSeconds - simAverage) * SMOOTHING;
+    if (settleFrames > 0) {
+        --settleFrames;
+        return false;
+    }
+
+    // Only the rendering shrinks with the scale.
+    if (average > budget * SLOW && average - simAverage >= simAverage) {
+        fastFrames = 0;
+        if (++slowFrames < SLOW_RUN) return false;
+        if (probing) probeBackoff = std::min(probeBackoff + 1, MAX_BACKOFF);
+        probing = false;
+        // Pixel cost goes with the square of the scale; the simulation's
+        // share of the frame stays.
+        const float target = scale * std::sqrt(std::max(budget - simAverage, 0.0f) / (average - simAverage));
+        const float drop = std::clamp(scale - target, STEP, MAX_DROP);
+        return change(std::floor((scale - drop) / STEP + 0.001f) * STEP);
+    }
+
+    slowFrames = 0;
+    if (average > budget * SLOW) {
+        // Simulation-bound: hold the scale, neither dropping nor climbing.
+        fastFrames = 0;
+        return false;
+    }
+    ++fastFrames;
+    if (average < budget * HEADROOM && fastFrames >= HEADROOM_RUN) {
+        probing = false;
+        probeBackoff = 0;
+        return change(scale + STEP);
+    }
+    // A probe that lasts this long has held.
+    if (probing && fastFrames >= HEADROOM_RUN) {
+        probing = false;
+        probeBackoff = std::max(probeBackoff - 1, 0);
+    }
+    if (scale < 1.0f && fastFrames >= PROBE_RUN << probeBackoff) {
+        probing = true;
+        return change(scale + STEP);
+    }
+    return false;
+}
+
+bool ResolutionScaler::change(float next) {
+    next = std::clamp(next, MIN_SCALE, 1.0f);
+    slowFrames = 0;
+    fastFrames = 0;
+    if (std::fabs(next - scale) < STEP * 0.5f) return false;
+    scale = next;
+    settleFrames = SETTLE_RUN;
+    return true;
+}
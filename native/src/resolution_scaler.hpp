@@ -0,0 +1,47 @@
+#pragma once
+
+// Picks the scale the scene renders at from measured frame times, so a
+// fill-bound machine trades resolution for frame rate. Scales are multiples
+// of STEP from MIN_SCALE to 1.
+//
+// A smoothed frame time over the budget for a run of frames drops the scale
+// by about what the overrun implies (pixel cost goes with the square of the
+// scale), but only while rendering takes at least as long as the
+// simulation: an overrun the simulation causes is QualityGovernor's to fix,
+// and a lower resolution would not help it. Raising it is cautious: with clear headroom it steps up after a
+// short run, but at a frame cap, where a frame that fits shows no headroom,
+// it only probes one step up after a longer run; every probe that is dropped
+// again doubles the wait before the next, and every one that holds halves
+// it. After any change the controller lets the average settle before
+// judging again.
+class ResolutionScaler {
+public:
+    static constexpr float STEP = 0.05f;
+    static constexpr float MIN_SCALE = 0.5f;
+
+    // Seconds per frame to hold.
+    void SetBudget(float seconds);
+    // Holds scale, rounded to a STEP and clamped to [MIN_SCALE, 1], from now
+    // on instead of adapting.
+    void Fix(float scale);
+
+    // Feeds one frame's duration and the part of it the simulation took.
+    // True when Scale() changed.
+    bool Update(float frameSeconds, float simSeconds);
+    float Scale() const { return scale; }
+
+private:
+    bool change(float next);
+
+    float budget{1.0f / 60.0f};
+    float scale{1.0f};
+    bool fixed{false};
+
+    float average{0.0f};
+    float simAverage{0.0f};
+    int slowFrames{0};
+    int fastFrames{0};
+    int settleFrames{0};
+    int probeBackoff{0};
+    bool probing{false};
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// PCG32 (XSH-RR, 64-bit state). Each system owns its own generator; the
+// stream id selects one of 2^63 independent sequences for the same seed, so
+// systems never share state and a seed reproduces a whole run.
+class Pcg32 {
+public:
+    explicit Pcg32(std::uint64_t seed = 0x853c49e6748fea9bULL, std::uint64_t stream = 0) { Seed(seed, stream); }
+
+    void Seed(std::uint64_t seed, std::uint64_t stream = 0) {
+        state = 0;
+        inc = (stream << 1u) | 1u;
+        NextU32();
+        state += seed;
+        NextU32();
+    }
+
+    std::uint32_t NextU32() {
+        const std::uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        const auto xorshifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+        const auto rot = static_cast<std::uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // Uniform in [0, 1), using the top 24 bits so every value is exact.
+    float NextFloat() { return static_cast<float>(NextU32() >> 8) * (1.0f / 16777216.0f); }
+
+    float Range(float minValue, float maxValue) { return minValue + (maxValue - minValue) * NextFloat(); }
+
+    // Uniform integer in [minValue, maxValue] without modulo bias.
+    int Next(int minValue, int maxValue) {
+        if (maxValue <= minValue) return minValue;
+        const std::uint32_t span = static_cast<std::uint32_t>(maxValue) - static_cast<std::uint32_t>(minValue) + 1u;
+        if (span == 0) return static_cast<int>(NextU32());
+        const std::uint32_t threshold = (0u - span) % span;
+        std::uint32_t r = NextU32();
+        while (r < threshold) r = NextU32();
+        return minValue + static_cast<int>(r % span);
+    }
+
+    // Writes count values uniform in [minValue, maxValue), consuming the same
+    // draws as count calls to NextFloat().
+    void Fill(float* out, std::size_t count, float minValue = 0.0f, float maxValue = 1.0f) {
+        const float scale = (maxValue - minValue) * (1.0f / 16777216.0f);
+        std::uint64_t s = state;
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::uint64_t old = s;
+            s = old * 6364136223846793005ULL + inc;
+            const auto xorshifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+            const auto rot = static_cast<std::uint32_t>(old >> 59u);
+            const std::uint32_t r = (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+            out[i] = minValue + static_cast<float>(r >> 8) * scale;
+        }
+        state = s;
+    }
+
+private:
+    std::uint64_t state{};
+    std::uint64_t inc{};
+};
@@ -0,0 +1,124 @@
+#include "shape_batch.hpp"
+
+#include <raymath.h>
+#include <rlgl.h>
+
+#include <cstddef>
+
+namespace {
+// Attribute locations, fixed in the shader source.
+constexpr int CORNER_ATTRIB = 0;
+constexpr int SHAPE_ATTRIB = 1;
+constexpr int COLOR_ATTRIB = 2;
+
+// Quads reach one unit past the outer radius to leave room for the
+// anti-aliased edge.
+constexpr const char* VERTEX_SHADER = R"(#version 330
+layout(location = 0) in vec2 corner;
+layout(location = 1) in vec4 shape;
+layout(location = 2) in vec4 color;
+uniform mat4 mvp;
+out vec2 local;
+out vec2 radii;
+out vec4 fragColor;
+void main() {
+    local = corner * (shape.z + 1.0);
+    radii = shape.zw;
+    fragColor = color;
+    gl_Position = mvp * vec4(shape.xy + local, 0.0, 1.0);
+}
+)";
+
+// Coverage ramps over one pixel across each edge, whatever the scale.
+constexpr const char* FRAGMENT_SHADER = R"(#version 330
+in vec2 local;
+in vec2 radii;
+in vec4 fragColor;
+out vec4 finalColor;
+void main() {
+    float r = length(local);
+    float aa = max(fwidth(r), 1e-4);
+    float coverage = clamp((radii.x - r) / aa + 0.5, 0.0, 1.0) * clamp((r - radii.y) / aa + 0.5, 0.0, 1.0);
+    if (coverage <= 0.0) discard;
+    finalColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
+)";
+
+constexpr float QUAD[12] = {-1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f};
+}
+
+ShapeBatch::~ShapeBatch() {
+    if (!ready) return;
+    rlUnloadVertexArray(vao);
+    rlUnloadVertexBuffer(quadVbo);
+    if (instanceVbo != 0) rlUnloadVertexBuffer(instanceVbo);
+    UnloadShader(shader);
+}
+
+void ShapeBatch::Init() {
+    shader = LoadShaderFromMemory(VERTEX_SHADER, FRAGMENT_SHADER);
+    if (shader.id == rlGetShaderIdDefault()) return;
+    mvpLoc = GetShaderLocation(shader, "mvp");
+
+    vao = rlLoadVertexArray();
+    rlEnableVertexArray(vao);
+    quadVbo = rlLoadVertexBuffer(QUAD, sizeof(QUAD), false);
+    rlSetVertexAttribute(CORNER_ATTRIB, 2, RL_FLOAT, false, 0, nullptr);
+    rlEnableVertexAttribute(CORNER_ATTRIB);
+    rlDisableVertexArray();
+    ready = vao != 0;
+}
+
+void ShapeBatch::Circle(Vector2 center, float radius, Color color) {
+    instances.push_back({center.x, center.y, radius, -1.0f, {color.r, color.g, color.b, color.a}});
+}
+
+void ShapeBatch::Ring(Vector2 center, float innerRadius, float outerRadius, Color color) {
+    instances.push_back({center.x, center.y, outerRadius, innerRadius, {color.r, color.g, color.b, color.a}});
+}
+
+void ShapeBatch::Flush() {
+    if (instances.empty()) return;
+    if (!ready) {
+        for (const Instance& s : instances) {
+            const Color color{s.color[0], s.color[1], s.color[2], s.color[3]};
+            if (s.inner < 0.0f)
+                DrawCircleV({s.x, s.y}, s.outer, color);
+            else
+                DrawRing({s.x, s.y}, s.inner, s.outer, 0.0f, 360.0f, 48, color);
+        }
+        instances.clear();
+        return;
+    }
+
+    // Draw what raylib has queued first, so the shapes land on top of it.
+    rlDrawRenderBatchActive();
+
+    const int count = static_cast<int>(instances.size());
+    const int bytes = count * static_cast<int>(sizeof(Instance));
+    rlEnableVertexArray(vao);
+    if (count > instanceCapacity) {
+        if (instanceVbo != 0) rlUnloadVertexBuffer(instanceVbo);
+        instanceCapacity = count + count / 2;
+        instanceVbo = rlLoadVertexBuffer(nullptr, instanceCapacity * static_cast<int>(sizeof(Instance)), true);
+        const int stride = static_cast<int>(sizeof(Instance));
+        rlSetVertexAttribute(SHAPE_ATTRIB, 4, RL_FLOAT, false, stride, reinterpret_cast<const void*>(offsetof(Instance, x)));
+        rlEnableVertexAttribute(SHAPE_ATTRIB);
+        rlSetVertexAttributeDivisor(SHAPE_ATTRIB, 1);
+        rlSetVertexAttribute(COLOR_ATTRIB, 4, RL_UNSIGNED_BYTE, true, stride,
+                             reinterpret_cast<const void*>(offsetof(Instance, color)));
+        rlEnableVertexAttribute(COLOR_ATTRIB);
+        rlSetVertexAttributeDivisor(COLOR_ATTRIB, 1);
+    }
+    rlUpdateVertexBuffer(instanceVbo, instances.data(), bytes, 0);
+
+    rlEnableShader(shader.id);
+    const Matrix model = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    rlSetUniformMatrix(mvpLoc, MatrixMultiply(model, rlGetMatrixProjection()));
+    rlDisableBackfaceCulling();
+    rlDrawVertexArrayInstanced(0, 6, count);
+    rlEnableBackfaceCulling();
+    rlDisableShader();
+    rlDisableVertexArray();
+    instances.clear();
+}
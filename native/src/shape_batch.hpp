@@ -0,0 +1,48 @@
+#pragma once
+
+#include <raylib.h>
+
+#include <vector>
+
+// Filled circles and rings drawn as instanced quads. Each shape is one
+// instance (centre, outer and inner radius, colour); a signed-distance
+// fragment shader cuts the disc or annulus out of its quad and anti-aliases
+// the edges, so nothing is tessellated on the CPU.
+//
+// Shapes queue until Flush(), which draws them in the order added with one
+// draw call after whatever raylib has queued so far. Callers flush at the end
+// of each layer so shapes and raylib's own drawing stack up as written.
+// Without a GL 3.3 context the shapes fall back to DrawCircleV and DrawRing.
+class ShapeBatch {
+public:
+    ShapeBatch() = default;
+    ~ShapeBatch();
+    ShapeBatch(const ShapeBatch&) = delete;
+    ShapeBatch& operator=(const ShapeBatch&) = delete;
+
+    // Needs the window's GL context.
+    void Init();
+
+    void Circle(Vector2 center, float radius, Color color);
+    void Ring(Vector2 center, float innerRadius, float outerRadius, Color color);
+    void Flush();
+
+private:
+    struct Instance {
+        float x;
+        float y;
+        float outer;
+        // Negative for a filled circle.
+        float inner;
+        unsigned char color[4];
+    };
+
+    std::vector<Instance> instances;
+    Shader shader{};
+    int mvpLoc{-1};
+    unsigned int vao{0};
+    unsigned int quadVbo{0};
+    unsigned int instanceVbo{0};
+    int instanceCapacity{0};
+    bool ready{false};
+};
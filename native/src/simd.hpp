@@ -0,0 +1,138 @@
+#pragma once
+
+// Thin lane wrappers used by the tentacle kernels. Each type exposes the same
+// free-function vocabulary (arithmetic, Sqrt, RsqrtEstimate, Min/Max,
+// comparisons producing a mask, Select, Any) so a kernel is written once as a template and
+// instantiated per instruction set. F32x1 is the portable fallback.
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ABYSSAL_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define ABYSSAL_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+// The lane code is compiled once per instruction set (see
+// tentacle_kernels.cpp), and each build puts it in its own inline namespace.
+// Otherwise the linker could keep, say, the AVX2 copy of an inline function
+// and hand it to SSE2 code running on a CPU without AVX2.
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+#define ABYSSAL_ISA_NAMESPACE isa_avx512
+#elif defined(ABYSSAL_HAVE_AVX2)
+#define ABYSSAL_ISA_NAMESPACE isa_avx2
+#elif defined(ABYSSAL_HAVE_SSE2)
+#define ABYSSAL_ISA_NAMESPACE isa_sse2
+#else
+#define ABYSSAL_ISA_NAMESPACE isa_scalar
+#endif
+
+inline namespace ABYSSAL_ISA_NAMESPACE {
+
+struct F32x1 {
+    static constexpr int Width = 1;
+    using Mask = bool;
+    float v;
+
+    static F32x1 Load(const float* p) { return {*p}; }
+    static F32x1 Set(float s) { return {s}; }
+    void Store(float* p) const { *p = v; }
+};
+
+inline F32x1 operator+(F32x1 a, F32x1 b) { return {a.v + b.v}; }
+inline F32x1 operator-(F32x1 a, F32x1 b) { return {a.v - b.v}; }
+inline F32x1 operator*(F32x1 a, F32x1 b) { return {a.v * b.v}; }
+inline F32x1 operator/(F32x1 a, F32x1 b) { return {a.v / b.v}; }
+inline bool operator<(F32x1 a, F32x1 b) { return a.v < b.v; }
+inline bool operator>=(F32x1 a, F32x1 b) { return a.v >= b.v; }
+inline bool operator!=(F32x1 a, F32x1 b) { return a.v != b.v; }
+inline F32x1 Sqrt(F32x1 a) { return {sqrtf(a.v)}; }
+// Same hardware estimate as the wide types, so Newton steps built on it agree
+// across lane widths.
+#if defined(ABYSSAL_HAVE_SSE2)
+inline F32x1 RsqrtEstimate(F32x1 a) { return {_mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(a.v)))}; }
+#else
+inline F32x1 RsqrtEstimate(F32x1 a) { return {1.0f / sqrtf(a.v)}; }
+#endif
+inline F32x1 Min(F32x1 a, F32x1 b) { return {b.v < a.v ? b.v : a.v}; }
+inline F32x1 Max(F32x1 a, F32x1 b) { return {a.v < b.v ? b.v : a.v}; }
+inline F32x1 Select(bool m, F32x1 a, F32x1 b) { return m ? a : b; }
+inline bool Any(bool m) { return m; }
+
+#if defined(ABYSSAL_HAVE_SSE2)
+struct M32x4 {
+    __m128 v;
+};
+
+struct F32x4 {
+    static constexpr int Width = 4;
+    using Mask = M32x4;
+    __m128 v;
+
+    static F32x4 Load(const float* p) { return {_mm_load_ps(p)}; }
+    static F32x4 Set(float s) { return {_mm_set1_ps(s)}; }
+    void Store(float* p) const { _mm_store_ps(p, v); }
+};
+
+inline F32x4 operator+(F32x4 a, F32x4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline F32x4 operator-(F32x4 a, F32x4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline F32x4 operator*(F32x4 a, F32x4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline F32x4 operator/(F32x4 a, F32x4 b) { return {_mm_div_ps(a.v, b.v)}; }
+inline M32x4 operator<(F32x4 a, F32x4 b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+inline M32x4 operator>=(F32x4 a, F32x4 b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+inline M32x4 operator!=(F32x4 a, F32x4 b) { return {_mm_cmpneq_ps(a.v, b.v)}; }
+inline M32x4 operator&(M32x4 a, M32x4 b) { return {_mm_and_ps(a.v, b.v)}; }
+inline F32x4 Sqrt(F32x4 a) { return {_mm_sqrt_ps(a.v)}; }
+inline F32x4 RsqrtEstimate(F32x4 a) { return {_mm_rsqrt_ps(a.v)}; }
+inline F32x4 Min(F32x4 a, F32x4 b) { return {_mm_min_ps(a.v, b.v)}; }
+inline F32x4 Max(F32x4 a, F32x4 b) { return {_mm_max_ps(a.v, b.v)}; }
+inline F32x4 Select(M32x4 m, F32x4 a, F32x4 b) {
+    return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))};
+}
+inline bool Any(M32x4 m) { return _mm_movemask_ps(m.v) != 0; }
+#endif
+
+#if defined(ABYSSAL_HAVE_AVX2)
+struct M32x8 {
+    __m256 v;
+};
+
+struct F32x8 {
+    static constexpr int Width = 8;
+    using Mask = M32x8;
+    __m256 v;
+
+    static F32x8 Load(const float* p) { return {_mm256_load_ps(p)}; }
+    static F32x8 Set(float s) { return {_mm256_set1_ps(s)}; }
+    void Store(float* p) const { _mm256_store_ps(p, v); }
+};
+
+inline F32x8 operator+(F32x8 a, F32x8 b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline F32x8 operator-(F32x8 a, F32x8 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline F32x8 operator*(F32x8 a, F32x8 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline F32x8 operator/(F32x8 a, F32x8 b) { return {_mm256_div_ps(a.v, b.v)}; }
+inline M32x8 operator<(F32x8 a, F32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+inline M32x8 operator>=(F32x8 a, F32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+inline M32x8 operator!=(F32x8 a, F32x8 b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_NEQ_UQ)}; }
+inline M32x8 operator&(M32x8 a, M32x8 b) { return {_mm256_and_ps(a.v, b.v)}; }
+inline F32x8 Sqrt(F32x8 a) { return {_mm256_sqrt_ps(a.v)}; }
+inline F32x8 RsqrtEstimate(F32x8 a) { return {_mm256_rsqrt_ps(a.v)}; }
+inline F32x8 Min(F32x8 a, F32x8 b) { return {_mm256_min_ps(a.v, b.v)}; }
+inline F32x8 Max(F32x8 a, F32x8 b) { return {_mm256_max_ps(a.v, b.v)}; }
+inline F32x8 Select(M32x8 m, F32x8 a, F32x8 b) { return {_mm256_blendv_ps(b.v, a.v, m.v)}; }
+inline bool Any(M32x8 m) { return _mm256_movemask_ps(m.v) != 0; }
+#endif
+
+// Widest lane type the current compiler flags allow.
+#if defined(ABYSSAL_HAVE_AVX2)
+using F32xN = F32x8;
+#elif defined(ABYSSAL_HAVE_SSE2)
+using F32xN = F32x4;
+#else
+using F32xN = F32x1;
+#endif
+}
@@ -0,0 +1,464 @@
+#include "simulation.hpp"
+
+#include "fast_math.hpp"
+#include "math_util.hpp"
+#include "particle_kernels.hpp"
+
+#include <raymath.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace {
+// PCG stream ids, one per system.
+enum RandomStream : std::uint64_t {
+    STREAM_TENTACLES = 1,
+    STREAM_BACKGROUND,
+    STREAM_TRAILS,
+    STREAM_PREY,
+    STREAM_BRIDGE,
+};
+}
+
+TrailParticle TrailParticles::At(std::size_t i) const {
+    TrailParticle p;
+    p.pos = {posX[i], posY[i]};
+    p.vel = {velX[i], velY[i]};
+    p.alpha = alpha[i];
+    p.size = size[i];
+    p.lifetime = lifetime[i];
+    p.maxLife = maxLife[i];
+    return p;
+}
+
+void TrailParticles::Push(const TrailParticle& p) {
+    posX.push_back(p.pos.x);
+    posY.push_back(p.pos.y);
+    velX.push_back(p.vel.x);
+    velY.push_back(p.vel.y);
+    alpha.push_back(p.alpha);
+    size.push_back(p.size);
+    lifetime.push_back(p.lifetime);
+    maxLife.push_back(p.maxLife);
+}
+
+void TrailParticles::Cull(std::size_t limit) {
+    const auto dead = [this](std::size_t i) { return lifetime[i] >= maxLife[i] || alpha[i] < 0.01f; };
+    std::size_t live = 0;
+    for (std::size_t i = 0; i < Count(); ++i) {
+        if (!dead(i)) ++live;
+    }
+    std::size_t oldest = live > limit ? live - limit : 0;
+    AlignedVector<float>* const arrays[] = {&posX, &posY, &velX, &velY, &alpha, &size, &lifetime, &maxLife};
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < Count(); ++i) {
+        if (dead(i)) continue;
+        if (oldest > 0) {
+            --oldest;
+            continue;
+        }
+        for (AlignedVector<float>* a : arrays) (*a)[kept] = (*a)[i];
+        ++kept;
+    }
+    for (AlignedVector<float>* a : arrays) a->resize(kept);
+}
+
+Simulation::Simulation(const SimConfig& config)
+    : jobs(config.threads),
+      backgroundRng(config.seed, STREAM_BACKGROUND),
+      trailRng(config.seed, STREAM_TRAILS),
+      preyRng(config.seed, STREAM_PREY),
+      bridgeRng(config.seed, STREAM_BRIDGE),
+      screenWidth(config.width),
+      screenHeight(config.height) {
+    mousePos = {static_cast<float>(screenWidth) * 0.5f, static_cast<float>(screenHeight) * 0.5f};
+    core.pos = {mousePos.x, mousePos.y, 0.0f};
+    core.radius = 60.0f;
+    prevCorePos = core.pos;
+    SetStepRate(config.stepHz);
+
+    for (int i = 0; i < maxPrey; ++i) {
+        spawnPrey();
+    }
+
+    RebuildBackground();
+
+    Pcg32 tentacleRng(config.seed, STREAM_TENTACLES);
+    if (config.tentacleGroups.empty()) {
+        tentacles.Init(core, config.tentacles, core.radius, tentacleRng);
+    } else {
+        tentacles.Init(core, config.tentacleGroups, core.radius, tentacleRng);
+    }
+    updateLodView();
+}
+
+void Simulation::spawnPrey() {
+    float margin = 100.0f;
+    Prey p;
+    p.pos = {
+        preyRng.Range(margin, screenWidth - margin),
+        preyRng.Range(margin, screenHeight - margin)
+    };
+    p.radius = preyRng.Range(14.0f, 22.0f);
+    p.pulsePhase = preyRng.Range(0.0f, PI2);
+    p.captured = false;
+    p.captureAnim = 0.0f;
+    p.spawnDelay = 0.0f;
+    prey.push_back(p);
+}
+
+void Simulation::ApplyInput(const SimInput& input) {
+    if (input.mousePressed) {
+        mouseDown = true;
+        mousePos = input.mousePos;
+        addRipple(mousePos);
+    } else if (input.mouseReleased) {
+        mouseDown = false;
+    }
+
+    if (mouseDown) {
+        mousePos = input.mousePos;
+    }
+
+    if (input.bridgeRequested) {
+        bridge.pending = true;
+    }
+    if (input.restartRequested) {
+        Reset();
+    }
+}
+
+void Simulation::addRipple(Vector2 pos) {
+    ripples.push_back({pos, nowMs, 0.9});
+}
+
+void Simulation::updateCore(float dt) {
+    // Gains are tuned per 60 Hz frame and core.vx/vy are in pixels per such
+    // frame; scale everything by the number of frames this step covers.
+    const float frames = dt * 60.0f;
+    const float stiffness = 0.02f;
+    const float drag = powf(0.85f, frames);
+    Vector2 delta = Vector2Subtract(mousePos, Vector2{core.pos.x, core.pos.y});
+    if (mouseDown) {
+        core.vx += delta.x * stiffness * frames;
+        core.vy += delta.y * stiffness * frames;
+    }
+    core.vx *= drag;
+    core.vy *= drag;
+    core.pos.x += core.vx * frames;
+    core.pos.y += core.vy * frames;
+}
+
+void Simulation::Resize(int width, int height) {
+    screenWidth = width;
+    screenHeight = height;
+    RebuildBackground();
+    updateLodView();
+}
+
+void Simulation::updateLodView() {
+    LodSettings lod = tentacles.GetLod();
+    lod.viewWidth = static_cast<float>(screenWidth);
+    lod.viewHeight = static_cast<float>(screenHeight);
+    tentacles.SetLod(lod);
+}
+
+void Simulation::RebuildBackground() {
+    background.clear();
+    fillBackground();
+}
+
+void Simulation::fillBackground() {
+    const float area = static_cast<float>(screenWidth * screenHeight);
+    const int full = std::clamp(static_cast<int>(area / 3600.0f), 90, 260);
+    const int density = static_cast<int>(std::lround(full * quality.backgroundDensity));
+    if (static_cast<int>(background.size()) >= density) {
+        background.resize(density);
+        return;
+    }
+    background.reserve(density);
+    for (int i = static_cast<int>(background.size()); i < density; ++i) {
+        float depth = backgroundRng.Range(0.25f, 1.0f);
+        background.push_back({
+            {backgroundRng.Range(0.0f, static_cast<float>(screenWidth)), backgroundRng.Range(0.0f, static_cast<float>(screenHeight))},
+            {(backgroundRng.Range(-0.5f, 0.5f)) * 6.0f, (backgroundRng.Range(-0.5f, 0.5f)) * 4.0f},
+            depth,
+            0.6f + depth * 1.4f,
+            backgroundRng.Range(0.0f, 1.0f)
+        });
+    }
+}
+
+void Simulation::SetQuality(const SimQuality& value) {
+    const bool densityChanged = value.backgroundDensity != quality.backgroundDensity;
+    quality = value;
+    quality.backgroundDensity = std::clamp(quality.backgroundDensity, 0.0f, 1.0f);
+    if (densityChanged) fillBackground();
+    LodSettings lod = tentacles.GetLod();
+    lod.maxIterations = quality.maxIterations;
+    tentacles.SetLod(lod);
+}
+
+void Simulation::updateBackground(float dt) {
+    const float frames = dt * 60.0f;
+    const float parallaxFactor = 0.12f * frames;
+    // Twinkle jitter is up to 0.01 per 60 Hz frame.
+    noise.resize(background.size());
+    backgroundRng.Fill(noise.data(), noise.size(), 0.0f, 0.01f * frames);
+    for (std::size_t i = 0; i < background.size(); ++i) {
+        auto& p = background[i];
+        float parallax = (1.0f - p.depth) * parallaxFactor;
+        p.pos.x -= core.vx * parallax;
+        p.pos.y -= core.vy * parallax;
+        p.pos.x += p.drift.x * dt;
+        p.pos.y += p.drift.y * dt;
+        p.twinkle = fmodf(p.twinkle + dt * 0.35f + noise[i], 1.0f);
+        if (p.pos.x < -50) p.pos.x += screenWidth + 100;
+        else if (p.pos.x > screenWidth + 50) p.pos.x -= screenWidth + 100;
+        if (p.pos.y < -50) p.pos.y += screenHeight + 100;
+        else if (p.pos.y > screenHeight + 50) p.pos.y -= screenHeight + 100;
+    }
+}
+
+void Simulation::updateRipples() {
+    ripples.erase(std::remove_if(ripples.begin(), ripples.end(), [&](const Ripple& r) {
+        return (nowMs - r.start) > (r.lifespan * 1000.0);
+    }), ripples.end());
+}
+
+void Simulation::maybeActivateEnergyBridge() {
+    if (!bridge.pending) return;
+    bridge.pending = false;
+    double elapsed = nowMs - bridge.lastTrigger;
+    if (bridge.isActive) return;
+    if (elapsed < bridge.cooldown * 1000.0) return;
+    bridge.isActive = true;
+    bridge.startTime = nowMs;
+    bridge.progress = 0.0f;
+    bridge.lastTrigger = nowMs;
+    bridge.particles.clear();
+    bridge.spawnAccumulator = 0.0f;
+    addRipple({core.pos.x, core.pos.y});
+    tentacles.Wake();
+}
+
+void Simulation::updateEnergyBridge(float dt) {
+    if (!bridge.isActive) return;
+    const double elapsed = nowMs - bridge.startTime;
+    bridge.progress = std::clamp(static_cast<float>(elapsed / (bridge.duration * 1000.0)), 0.0f, 1.0f);
+    if (elapsed >= bridge.duration * 1000.0) {
+        bridge.isActive = false;
+        bridge.particles.clear();
+        return;
+    }
+
+    const int tipCount = static_cast<int>(tipCache.size());
+    const int targetParticles = std::min(120, std::max(1, tipCount * 4));
+    bridge.spawnAccumulator += dt * tipCount * 1.2f;
+    while (bridge.spawnAccumulator > 1.0f && static_cast<int>(bridge.particles.size()) < targetParticles) {
+        bridge.spawnAccumulator -= 1.0f;
+        bridge.particles.push_back({bridgeRng.Next(0, std::max(0, tipCount - 1)), bridgeRng.Range(0.0f, 0.4f), bridgeRng.Range(0.35f, 1.0f)});
+    }
+
+    for (auto it = bridge.particles.begin(); it != bridge.particles.end();) {
+        it->t += dt * it->speed;
+        if (it->t > 1.1f) {
+            it = bridge.particles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Simulation::updateTrails(float dt) {
+    const float frames = dt * 60.0f;
+    // 40% per 60 Hz frame per tip at full quality
+    const float spawnChance = (1.0f - powf(0.6f, frames)) * quality.trailSpawn;
+    const float shrink = powf(0.97f, frames);
+    const float slow = powf(0.95f, frames);
+
+    // Spawn new trail particles at tentacle tips
+    noise.resize(tipCache.size());
+    trailRng.Fill(noise.data(), noise.size());
+    for (std::size_t i = 0; i < tipCache.size(); ++i) {
+        if (noise[i] < spawnChance) {
+            TrailParticle tp;
+            tp.pos = {tipScreenX[i], tipScreenY[i]};
+            tp.vel = {trailRng.Range(-15.0f, 15.0f), trailRng.Range(-15.0f, 15.0f)};
+            tp.alpha = 0.8f;
+            tp.size = trailRng.Range(2.0f, 5.0f);
+            tp.lifetime = 0.0f;
+            tp.maxLife = trailRng.Range(0.3f, 0.7f);
+            trails.Push(tp);
+        }
+    }
+
+    // Update existing trails
+    TrailBlock block{};
+    block.posX = trails.posX.data();
+    block.posY = trails.posY.data();
+    block.velX = trails.velX.data();
+    block.velY = trails.velY.data();
+    block.alpha = trails.alpha.data();
+    block.size = trails.size.data();
+    block.lifetime = trails.lifetime.data();
+    block.maxLife = trails.maxLife.data();
+    block.count = trails.Count();
+    block.dt = dt;
+    block.shrink = shrink;
+    block.slow = slow;
+    ParticleKernelsFor(tentacles.GetSimdIsa()).advanceTrails(block);
+
+    // Drop dead trails, then the oldest beyond the limit
+    trails.Cull(static_cast<std::size_t>(std::max(quality.maxTrails, 0)));
+}
+
+void Simulation::updatePrey(float dt) {
+    const ParticleKernels hits = ParticleKernelsFor(tentacles.GetSimdIsa());
+    for (auto& p : prey) {
+        if (p.captured) {
+            p.captureAnim += dt * 3.0f;
+            if (p.captureAnim >= 1.0f && !gameOver) {
+                // Respawn after delay (only if game is still running)
+                p.spawnDelay += dt;
+                if (p.spawnDelay > 2.0f) {
+                    float margin = 100.0f;
+                    p.pos = {
+                        preyRng.Range(margin, screenWidth - margin),
+                        preyRng.Range(margin, screenHeight - margin)
+                    };
+                    p.radius = preyRng.Range(14.0f, 22.0f);
+                    p.captured = false;
+                    p.captureAnim = 0.0f;
+                    p.spawnDelay = 0.0f;
+                }
+            }
+            continue;
+        }
+
+        // Update pulse
+        p.pulsePhase = fmodf(p.pulsePhase + dt * 3.0f, PI2);
+
+        // Check collision with tentacle tips (only if game is running)
+        if (!gameOver) {
+            const float reach = p.radius + 8.0f;
+            const int hit =
+                hits.firstWithin(tipScreenX.data(), tipScreenY.data(), tipScreenX.size(), p.pos.x, p.pos.y, reach);
+            if (hit >= 0) {
+                p.captured = true;
+                p.captureAnim = 0.0f;
+                score += 10;
+                addRipple(p.pos);
+            }
+        }
+
+        // Gentle drift away from core
+        float toCoreDx = p.pos.x - core.pos.x;
+        float toCoreDy = p.pos.y - core.pos.y;
+        float toCoreLen2 = toCoreDx * toCoreDx + toCoreDy * toCoreDy;
+        if (toCoreLen2 > 1.0f && toCoreLen2 < 300.0f * 300.0f) {
+            float inv = Rsqrt(toCoreLen2);
+            float flee = 20.0f * inv;
+            p.pos.x += (toCoreDx * inv) * flee * dt;
+            p.pos.y += (toCoreDy * inv) * flee * dt;
+        }
+
+        // Keep in bounds
+        float margin = 50.0f;
+        if (p.pos.x < margin) p.pos.x = margin;
+        if (p.pos.x > screenWidth - margin) p.pos.x = screenWidth - margin;
+        if (p.pos.y < margin) p.pos.y = margin;
+        if (p.pos.y > screenHeight - margin) p.pos.y = screenHeight - margin;
+    }
+}
+
+void Simulation::updateTimer(float dt) {
+    if (gameOver) return;
+
+    gameTimer -= dt;
+    if (gameTimer <= 0.0f) {
+        gameTimer = 0.0f;
+        gameOver = true;
+        if (score > highScore) {
+            highScore = score;
+        }
+    }
+}
+
+void Simulation::Reset() {
+    gameTimer = maxTime;
+    gameOver = false;
+    score = 0;
+
+    // Reset all prey
+    prey.clear();
+    for (int i = 0; i < maxPrey; ++i) {
+        spawnPrey();
+    }
+}
+
+void Simulation::SetStepRate(float hz) {
+    fixedStep = 1.0f / std::clamp(hz, 15.0f, 480.0f);
+    accumulator = 0.0f;
+}
+
+int Simulation::Frame(SimInputSource& input, SimClock& clock) {
+    const double now = clock.Seconds();
+    const float frameDt = lastClock < 0.0 ? 0.0f : static_cast<float>(now - lastClock);
+    lastClock = now;
+    ApplyInput(input.Poll());
+    return Advance(frameDt);
+}
+
+int Simulation::Advance(float frameDt) {
+    // Clamp long frames (window drags, breakpoints) so a hitch slows the
+    // simulation down instead of making it explode or spiral.
+    accumulator += std::min(std::max(frameDt, 0.0f), fixedStep * maxStepsPerFrame);
+    int steps = 0;
+    while (accumulator >= fixedStep) {
+        Step(fixedStep);
+        accumulator -= fixedStep;
+        ++steps;
+    }
+    renderAlpha = std::clamp(accumulator / fixedStep, 0.0f, 1.0f);
+    return steps;
+}
+
+void Simulation::Step(float dt) {
+    nowMs += dt * 1000.0;
+    prevCorePos = core.pos;
+
+    updateTimer(dt);
+    updateCore(dt);
+    updateBackground(dt);
+    updateRipples();
+    maybeActivateEnergyBridge();
+
+    core.avAccum = 0.0f;
+    core.avCount = 0;
+
+    tentacles.Update(dt, nowMs, mouseDown, ring, core, &jobs);
+    tipCache.clear();
+    tipScreenX.clear();
+    tipScreenY.clear();
+    for (int i = 0; i < tentacles.Count(); ++i) {
+        tipCache.push_back(tentacles.Tip(i));
+        const ScreenPoint projected = ProjectPoint(core.pos, tipCache.back());
+        tipScreenX.push_back(projected.pos.x);
+        tipScreenY.push_back(projected.pos.y);
+    }
+
+    if (core.avCount > 0) {
+        const float frames = dt * 60.0f;
+        const float afr = powf(ring.friction, frames);
+        const float avg = core.avAccum / static_cast<float>(core.avCount);
+        ring.angularVelocity = (ring.angularVelocity + avg * frames) * afr;
+        ring.angularVelocity = std::clamp(ring.angularVelocity, -ring.maxAV, ring.maxAV);
+        ring.offset = ClampAngle(ring.offset + ring.angularVelocity * dt);
+    }
+
+    updateEnergyBridge(dt);
+    updateTrails(dt);
+    updatePrey(dt);
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+// Game simulation without any windowing or rendering. Only raylib's plain
+// value types (Vector2, Vector3) and the header-only raymath are used, so
+// this builds into abyssal_sim and runs on machines without a GPU. Time and
+// input come in through the interfaces below; randomness comes from
+// per-system PCG streams derived from SimConfig::seed.
+
+#include "job_system.hpp"
+#include "rng.hpp"
+#include "tentacle_bank.hpp"
+
+#include <raylib.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct BackgroundParticle {
+    Vector2 pos{};
+    Vector2 drift{};
+    float depth{};
+    float size{};
+    float twinkle{};
+};
+
+struct Ripple {
+    Vector2 pos{};
+    double start{0.0};
+    double lifespan{0.9};
+};
+
+struct TrailParticle {
+    Vector2 pos{};
+    Vector2 vel{};
+    float alpha{1.0f};
+    float size{3.0f};
+    float lifetime{0.0f};
+    float maxLife{0.5f};
+};
+
+// Trail particles as structure-of-arrays, oldest first, so ParticleKernels
+// can step them a lane block at a time.
+struct TrailParticles {
+    AlignedVector<float> posX;
+    AlignedVector<float> posY;
+    AlignedVector<float> velX;
+    AlignedVector<float> velY;
+    AlignedVector<float> alpha;
+    AlignedVector<float> size;
+    AlignedVector<float> lifetime;
+    AlignedVector<float> maxLife;
+
+    std::size_t Count() const { return posX.size(); }
+    TrailParticle At(std::size_t i) const;
+    void Push(const TrailParticle& p);
+    // Drops dead particles, then the oldest beyond limit, keeping the order.
+    void Cull(std::size_t limit);
+};
+
+struct Prey {
+    Vector2 pos{};
+    float radius{18.0f};
+    float pulsePhase{0.0f};
+    bool captured{false};
+    float captureAnim{0.0f};
+    float spawnDelay{0.0f};
+};
+
+struct AnchorRing {
+    float offset{0.0f};
+    float angularVelocity{0.0f};
+    float friction{0.9f};
+    float maxAV{6.0f};
+};
+
+struct Core {
+    Vector3 pos{0.0f, 0.0f, 0.0f};
+    Vector2 vel{0.0f, 0.0f};
+    float radius{50.0f};
+    float vx{0.0f};
+    float vy{0.0f};
+    float avAccum{0.0f};
+    int avCount{0};
+};
+
+struct EnergyParticle {
+    int tipIndex{0};
+    float t{0.0f};
+    float speed{1.0f};
+};
+
+struct EnergyBridge {
+    bool isActive{false};
+    bool pending{false};
+    float progress{0.0f};
+    double startTime{0.0};
+    double lastTrigger{-1e9};
+    float duration{3.0f};
+    float cooldown{3.5f};
+    float spawnAccumulator{0.0f};
+    std::vector<EnergyParticle> particles;
+};
+
+// Player input gathered once per frame.
+struct SimInput {
+    Vector2 mousePos{};
+    bool mousePressed{false};
+    bool mouseReleased{false};
+    bool bridgeRequested{false};
+    bool restartRequested{false};
+};
+
+class SimInputSource {
+public:
+    virtual ~SimInputSource() = default;
+    virtual SimInput Poll() = 0;
+};
+
+// Monotonic wall clock in seconds; only differences are used.
+class SimClock {
+public:
+    virtual ~SimClock() = default;
+    virtual double Seconds() = 0;
+};
+
+struct SimConfig {
+    int width{1280};
+    int height{720};
+    int tentacles{30};
+    // Species on the core; empty means tentacles of the default archetype.
+    std::vector<TentacleGroup> tentacleGroups;
+    float stepHz{60.0f};
+    unsigned threads{0};
+    std::uint64_t seed{1};
+};
+
+// How much detail the simulation spends on effects and the solver. The
+// defaults are full quality; the engine lowers them when frames run long.
+struct SimQuality {
+    // Trail particles alive at once, and the share of the usual spawn rate.
+    int maxTrails{500};
+    float trailSpawn{1.0f};
+    // Share of the background stars the window's area calls for.
+    float backgroundDensity{1.0f};
+    // Constraint passes per step at most; 0 keeps each species' own.
+    int maxIterations{0};
+};
+
+class Simulation {
+public:
+    explicit Simulation(const SimConfig& config);
+
+    // Polls input once, then advances by the wall time that passed since the
+    // previous call. Returns the number of steps taken.
+    int Frame(SimInputSource& input, SimClock& clock);
+    // Runs as many fixed steps as frameDt covers; the remainder is carried
+    // over to the next call.
+    int Advance(float frameDt);
+    void ApplyInput(const SimInput& input);
+    void Step(float dt);
+    void SetStepRate(float hz);
+    float StepSeconds() const { return fixedStep; }
+    // Fraction of a step left in the accumulator, for render interpolation.
+    float RenderAlpha() const { return renderAlpha; }
+
+    void Resize(int width, int height);
+    void RebuildBackground();
+    void Reset();
+    // Stars are added or dropped to the new density; the rest stay put.
+    void SetQuality(const SimQuality& value);
+    const SimQuality& Quality() const { return quality; }
+
+    const Core& GetCore() const { return core; }
+    Vector3 PrevCorePos() const { return prevCorePos; }
+    TentacleBank& Tentacles() { return tentacles; }
+    const TentacleBank& Tentacles() const { return tentacles; }
+    const std::vector<Vector3>& Tips() const { return tipCache; }
+    const EnergyBridge& Bridge() const { return bridge; }
+    const std::vector<BackgroundParticle>& Background() const { return background; }
+    const std::vector<Ripple>& Ripples() const { return ripples; }
+    const TrailParticles& Trails() const { return trails; }
+    const std::vector<Prey>& PreyList() const { return prey; }
+    double NowMs() const { return nowMs; }
+    int Score() const { return score; }
+    int HighScore() const { return highScore; }
+    float TimeLeft() const { return gameTimer; }
+    float MaxTime() const { return maxTime; }
+    bool GameOver() const { return gameOver; }
+    int Width() const { return screenWidth; }
+    int Height() const { return screenHeight; }
+
+private:
+    void updateCore(float dt);
+    void fillBackground();
+    void updateBackground(float dt);
+    void addRipple(Vector2 pos);
+    void updateRipples();
+    void updateEnergyBridge(float dt);
+    void maybeActivateEnergyBridge();
+    void updateTrails(float dt);
+    void updatePrey(float dt);
+    void spawnPrey();
+    void updateTimer(float dt);
+    void updateLodView();
+    JobSystem jobs;
+
+    // One stream per system so their draws never interleave.
+    Pcg32 backgroundRng;
+    Pcg32 trailRng;
+    Pcg32 preyRng;
+    Pcg32 bridgeRng;
+    std::vector<float> noise;
+
+    int screenWidth{};
+    int screenHeight{};
+    Vector2 mousePos{};
+    bool mouseDown{false};
+    double nowMs{0.0};
+
+    // Fixed-step clock
+    float fixedStep{1.0f / 60.0f};
+    float accumulator{0.0f};
+    float renderAlpha{1.0f};
+    int maxStepsPerFrame{8};
+    double lastClock{-1.0};
+    Vector3 prevCorePos{};
+
+    Core core;
+    AnchorRing ring;
+    TentacleBank tentacles;
+    EnergyBridge bridge;
+    std::vector<BackgroundParticle> background;
+    std::vector<Ripple> ripples;
+    std::vector<Vector3> tipCache;
+    // Tips projected to the screen, for the trail spawns and prey hit test.
+    AlignedVector<float> tipScreenX;
+    AlignedVector<float> tipScreenY;
+
+    SimQuality quality;
+
+    // Trail particles
+    TrailParticles trails;
+
+    // Prey system
+    std::vector<Prey> prey;
+    int score{0};
+    int maxPrey{8};
+
+    // Timer system
+    float gameTimer{60.0f};
+    float maxTime{60.0f};
+    bool gameOver{false};
+    int highScore{0};
+};
@@ -0,0 +1,122 @@
+#include "strip_mesh.hpp"
+
+#include "fast_math.hpp"
+
+#include <raymath.h>
+#include <rlgl.h>
+
+#include <algorithm>
+
+namespace {
+// Longest miter, in half widths, before a sharp joint is clipped.
+constexpr float MITER_LIMIT = 2.0f;
+}
+
+Vector2 StripDirection(Vector2 a, Vector2 b) {
+    const Vector2 d{b.x - a.x, b.y - a.y};
+    const float len2 = d.x * d.x + d.y * d.y;
+    if (len2 < 1e-12f) return {0.0f, 0.0f};
+    const float inv = Rsqrt(len2);
+    return {d.x * inv, d.y * inv};
+}
+
+Vector2 MiterOffset(Vector2 in, Vector2 out, float halfWidth) {
+    const bool hasIn = in.x != 0.0f || in.y != 0.0f;
+    const Vector2 along = hasIn ? in : out;
+    Vector2 tangent = StripDirection({0.0f, 0.0f}, {in.x + out.x, in.y + out.y});
+    if (tangent.x == 0.0f && tangent.y == 0.0f) tangent = along;
+    const float cosHalf = std::max(tangent.x * along.x + tangent.y * along.y, 1.0f / MITER_LIMIT);
+    const float half = halfWidth / cosHalf;
+    return {-tangent.y * half, tangent.x * half};
+}
+
+StripMesh::~StripMesh() {
+    for (Chunk& chunk : chunks) UnloadMesh(chunk.mesh);
+    if (materialLoaded) UnloadMaterial(material);
+}
+
+void StripMesh::Clear() {
+    usedChunks = 0;
+    openChunk = 0;
+}
+
+int StripMesh::Split() {
+    openChunk = usedChunks;
+    return usedChunks;
+}
+
+StripMesh::Strips StripMesh::Add(int count, int joints) {
+    Chunk& chunk = chunkFor(2 * joints * count);
+    const int base = chunk.vertices;
+    unsigned short* indices = chunk.mesh.indices + chunk.triangles * 3;
+    for (int strip = 0; strip < count; ++strip) {
+        const int first = base + strip * 2 * joints;
+        for (int i = 0; i < joints - 1; ++i) {
+            const auto v = static_cast<unsigned short>(first + 2 * i);
+            const unsigned short quad[6] = {v, static_cast<unsigned short>(v + 1), static_cast<unsigned short>(v + 2),
+                                             static_cast<unsigned short>(v + 2), static_cast<unsigned short>(v + 1),
+                                             static_cast<unsigned short>(v + 3)};
+            std::copy(quad, quad + 6, indices);
+            indices += 6;
+        }
+    }
+    chunk.vertices += 2 * joints * count;
+    chunk.triangles += 2 * (joints - 1) * count;
+    return {chunk.mesh.vertices + base * 3, chunk.mesh.colors + base * 4};
+}
+
+void StripMesh::Upload() {
+    for (int i = 0; i < usedChunks; ++i) {
+        const Chunk& chunk = chunks[i];
+        const Mesh& mesh = chunk.mesh;
+        rlUpdateVertexBuffer(mesh.vboId[0], mesh.vertices, chunk.vertices * 3 * static_cast<int>(sizeof(float)), 0);
+        rlUpdateVertexBuffer(mesh.vboId[3], mesh.colors, chunk.vertices * 4, 0);
+        // Element buffers bind to the current vertex array, so bind ours.
+        rlEnableVertexArray(mesh.vaoId);
+        rlUpdateVertexBufferElements(mesh.vboId[6], mesh.indices,
+                                     chunk.triangles * 3 * static_cast<int>(sizeof(unsigned short)), 0);
+        rlDisableVertexArray();
+    }
+}
+
+StripMesh::Chunk& StripMesh::chunkFor(int vertices) {
+    if (usedChunks > openChunk && chunks[usedChunks - 1].vertices + vertices <= CHUNK_VERTICES) {
+        return chunks[usedChunks - 1];
+    }
+    if (!materialLoaded) {
+        material = LoadMaterialDefault();
+        materialLoaded = true;
+    }
+    if (usedChunks == static_cast<int>(chunks.size())) {
+        // Every chunk has room for CHUNK_VERTICES vertices and, as a strip
+        // has fewer triangles than vertices, as many triangles.
+        Chunk chunk;
+        Mesh& mesh = chunk.mesh;
+        mesh.vertexCount = CHUNK_VERTICES;
+        mesh.triangleCount = CHUNK_VERTICES;
+        mesh.vertices = static_cast<float*>(MemAlloc(CHUNK_VERTICES * 3 * sizeof(float)));
+        mesh.texcoords = static_cast<float*>(MemAlloc(CHUNK_VERTICES * 2 * sizeof(float)));
+        mesh.colors = static_cast<unsigned char*>(MemAlloc(CHUNK_VERTICES * 4));
+        mesh.indices = static_cast<unsigned short*>(MemAlloc(CHUNK_VERTICES * 3 * sizeof(unsigned short)));
+        UploadMesh(&mesh, true);
+        chunks.push_back(chunk);
+    }
+    Chunk& chunk = chunks[usedChunks++];
+    chunk.vertices = 0;
+    chunk.triangles = 0;
+    return chunk;
+}
+
+void StripMesh::Draw(int first, int last) const {
+    if (first >= last) return;
+    // Meshes draw straight away; flush what is queued so the order holds.
+    rlDrawRenderBatchActive();
+    // Strips turn both ways on screen, so both windings must draw.
+    rlDisableBackfaceCulling();
+    for (int i = first; i < last; ++i) {
+        Mesh mesh = chunks[i].mesh;
+        mesh.triangleCount = chunks[i].triangles;
+        if (mesh.triangleCount > 0) DrawMesh(mesh, material, MatrixIdentity());
+    }
+    rlEnableBackfaceCulling();
+}
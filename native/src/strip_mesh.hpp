@@ -0,0 +1,63 @@
+#pragma once
+
+#include <raylib.h>
+
+#include <vector>
+
+// Unit vector from a to b, or zero if they coincide.
+Vector2 StripDirection(Vector2 a, Vector2 b);
+// Offset from a joint to one edge of a strip halfWidth wide, where the
+// segment into the joint runs along in and the one out of it along out
+// (zero at an end). The miter keeps the edges parallel to both segments,
+// clipped at twice halfWidth on sharp turns.
+Vector2 MiterOffset(Vector2 in, Vector2 out, float halfWidth);
+
+// Triangle strips in persistent vertex buffers, refilled and uploaded every
+// frame. rlgl indexes with 16 bits, so the strips are spread over meshes of
+// up to CHUNK_VERTICES vertices, each drawn with one call; within a chunk
+// they draw in the order added.
+class StripMesh {
+public:
+    static constexpr int CHUNK_VERTICES = 65536;
+
+    // Where Add()'s strips go: two vertices (x, y, z) and two colours
+    // (r, g, b, a) per joint, one strip after another.
+    struct Strips {
+        float* vertices;
+        unsigned char* colors;
+    };
+
+    StripMesh() = default;
+    ~StripMesh();
+    StripMesh(const StripMesh&) = delete;
+    StripMesh& operator=(const StripMesh&) = delete;
+
+    // Empties the mesh for a new frame.
+    void Clear();
+    // Strips added from now on start a new chunk, so something else can be
+    // drawn between the chunks before and after. Returns the number before.
+    int Split();
+    // Room for count strips of joints joints each, in one chunk.
+    Strips Add(int count, int joints);
+    void Upload();
+    int Chunks() const { return usedChunks; }
+    // Draws chunks first to last - 1.
+    void Draw(int first, int last) const;
+    void Draw() const { Draw(0, usedChunks); }
+
+private:
+    struct Chunk {
+        Mesh mesh{};
+        int vertices{0};
+        int triangles{0};
+    };
+
+    Chunk& chunkFor(int vertices);
+
+    std::vector<Chunk> chunks;
+    int usedChunks{0};
+    // Chunks before this one take no more strips.
+    int openChunk{0};
+    Material material{};
+    bool materialLoaded{false};
+};
@@ -0,0 +1,1039 @@
+#include "tentacle_bank.hpp"
+
+#include "job_system.hpp"
+#include "math_util.hpp"
+#include "rng.hpp"
+#include "fast_math.hpp"
+#include "simulation.hpp"
+#include "tentacle_kernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+
+void TentacleBank::Init(const Core& core, int tentacleCount, float attachRadiusIn, Pcg32& rng,
+                        const TentacleArchetype& archetype) {
+    Init(core, {TentacleGroup{archetype, tentacleCount}}, attachRadiusIn, rng);
+}
+
+void TentacleBank::Init(const Core& core, const std::vector<TentacleGroup>& groups, float attachRadiusIn, Pcg32& rng) {
+    archetypes.clear();
+    std::vector<int> groupCount;
+    for (const TentacleGroup& group : groups) {
+        if (group.count <= 0 || static_cast<int>(archetypes.size()) == MAX_ARCHETYPES) continue;
+        archetypes.push_back(group.archetype);
+        archetypes.back().segments = std::clamp(group.archetype.segments, 1, MAX_CHAIN_SEGMENTS);
+        groupCount.push_back(group.count);
+    }
+    if (archetypes.empty()) {
+        archetypes.emplace_back();
+        groupCount.push_back(0);
+    }
+
+    // Each group fills whole blocks; tentacles take slots in group order.
+    count = 0;
+    paddedCount = 0;
+    capacity = 1;
+    blockArchetype.clear();
+    blockLanes.clear();
+    slotOf.clear();
+    for (std::size_t a = 0; a < archetypes.size(); ++a) {
+        const int n = groupCount[a];
+        for (int t = 0; t < n; ++t) {
+            slotOf.push_back(paddedCount + t);
+        }
+        for (int first = 0; first < n; first += LANES) {
+            blockArchetype.push_back(static_cast<int>(a));
+            blockLanes.push_back(std::min(LANES, n - first));
+        }
+        count += n;
+        paddedCount += (n + LANES - 1) / LANES * LANES;
+        capacity = std::max(capacity, archetypes[a].segments);
+    }
+    attachRadius = attachRadiusIn;
+
+    const std::size_t total = static_cast<std::size_t>(paddedCount) * capacity;
+    x.assign(total, 0.0f);
+    y.assign(total, 0.0f);
+    z.assign(total, 0.0f);
+    prevX.assign(total, 0.0f);
+    prevY.assign(total, 0.0f);
+    prevZ.assign(total, 0.0f);
+    driftX.assign(total, 0.0f);
+    driftY.assign(total, 0.0f);
+    driftZ.assign(total, 0.0f);
+    heldX.assign(total, 0.0f);
+    heldY.assign(total, 0.0f);
+
+    baseAngle.assign(paddedCount, 0.0f);
+    anchorAngle.assign(paddedCount, 0.0f);
+    anchorAV.assign(paddedCount, 0.0f);
+    animationSeed.assign(paddedCount, 0.0f);
+    lastAttachX.assign(paddedCount, 0.0f);
+    lastAttachY.assign(paddedCount, 0.0f);
+    lastAttachZ.assign(paddedCount, 0.0f);
+    coreTangentialVelocity.assign(paddedCount, 0.0f);
+    attachX.assign(paddedCount, 0.0f);
+    attachY.assign(paddedCount, 0.0f);
+    attachZ.assign(paddedCount, 0.0f);
+    attachVX.assign(paddedCount, 0.0f);
+    attachVY.assign(paddedCount, 0.0f);
+    anchorCos.assign(paddedCount, 1.0f);
+    anchorSin.assign(paddedCount, 0.0f);
+    coreGain.assign(paddedCount, 0.8f);
+
+    const int blocks = paddedCount / LANES;
+    blockTier.assign(blocks, 0);
+    blockSegments.resize(blocks);
+    for (int b = 0; b < blocks; ++b) {
+        blockSegments[b] = archetypes[blockArchetype[b]].segments;
+    }
+    blockDwell.assign(blocks, 0);
+    kineticEnergy.assign(paddedCount, 0.0f);
+    stretchError.assign(paddedCount, 0.0f);
+    drivenError.assign(paddedCount, 0.0f);
+    blockCalmSteps.assign(blocks, 0);
+    blockAsleep.assign(blocks, 0);
+    blockHeldPhase.assign(blocks, 0.0f);
+    blockPasses.assign(blocks, 0);
+    blockResidual.assign(blocks, 0.0f);
+    solverStats = {};
+
+    // Species are interleaved around the ring: tentacle j of a group of n
+    // sits at fraction (j + 0.5) / n of the way round, and ring places go out
+    // in that order. A single group keeps its index order.
+    std::vector<int> ringOrder(count);
+    std::vector<float> ringFraction(count);
+    for (std::size_t a = 0, t = 0; a < archetypes.size(); ++a) {
+        for (int j = 0; j < groupCount[a]; ++j, ++t) {
+            ringOrder[t] = static_cast<int>(t);
+            ringFraction[t] = (static_cast<float>(j) + 0.5f) / static_cast<float>(groupCount[a]);
+        }
+    }
+    std::stable_sort(ringOrder.begin(), ringOrder.end(),
+                     [&](int a, int b) { return ringFraction[a] < ringFraction[b]; });
+
+    anchorOrder.resize(count);
+    anchorRank.assign(paddedCount, 0);
+    const float spacing = PI2 / static_cast<float>(std::max(count, 1));
+    // Padding lanes get a valid resting chain so the kernels never see
+    // garbage, but they are never anchored, drawn or reported.
+    for (int s = 0; s < paddedCount; ++s) {
+        baseAngle[s] = spacing * s;
+    }
+    for (int place = 0; place < count; ++place) {
+        const int s = slotOf[ringOrder[place]];
+        anchorOrder[place] = s;
+        baseAngle[s] = spacing * place;
+    }
+    for (int t = 0; t < count; ++t) {
+        animationSeed[slotOf[t]] = rng.Range(0.0f, 100.0f);
+    }
+    for (int s = 0; s < paddedCount; ++s) {
+        const TentacleArchetype& params = archetypeOfSlot(s);
+        const float angle = baseAngle[s];
+        anchorAngle[s] = angle;
+        for (int i = 0; i < params.segments; ++i) {
+            const std::size_t k = at(s, i);
+            float dist = attachRadius + i * params.segmentLength;
+            x[k] = core.pos.x + cosf(angle) * dist;
+            y[k] = core.pos.y + sinf(angle) * dist;
+            prevX[k] = x[k];
+            prevY[k] = y[k];
+        }
+        lastAttachX[s] = attachX[s] = x[at(s, 0)];
+        lastAttachY[s] = attachY[s] = y[at(s, 0)];
+    }
+    tickX = x;
+    tickY = y;
+    tickZ = z;
+}
+
+void TentacleBank::SetIterationRange(int minIterations, int maxIterations) {
+    for (TentacleArchetype& params : archetypes) {
+        params.maxIterations = std::max(maxIterations, 0);
+        params.minIterations = std::clamp(minIterations, 0, params.maxIterations);
+    }
+}
+
+int TentacleBank::TierSegments(int tier, int archetype) const {
+    // Fractions of the full chain; the coarsest keeps enough joints to bend.
+    static constexpr float fractions[LOD_TIERS] = {1.0f, 0.66f, 0.4f, 0.25f};
+    tier = std::clamp(tier, 0, LOD_TIERS - 1);
+    const int full = archetypes[archetype].segments;
+    const int segments = static_cast<int>(std::lround((full - 1) * fractions[tier])) + 1;
+    return std::min(full, std::max(segments, 4));
+}
+
+int TentacleBank::FullDetailSegments() const {
+    int total = 0;
+    for (std::size_t b = 0; b < blockLanes.size(); ++b) {
+        total += archetypes[blockArchetype[b]].segments * blockLanes[b];
+    }
+    return total;
+}
+
+int TentacleBank::ActiveSegments() const {
+    int total = 0;
+    for (std::size_t b = 0; b < blockLanes.size(); ++b) {
+        total += blockSegments[b] * blockLanes[b];
+    }
+    return total;
+}
+
+int TentacleBank::SleepingCount() const {
+    int total = 0;
+    for (std::size_t b = 0; b < blockLanes.size(); ++b) {
+        if (blockAsleep[b]) total += blockLanes[b];
+    }
+    return total;
+}
+
+void TentacleBank::Wake() {
+    std::fill(blockCalmSteps.begin(), blockCalmSteps.end(), 0);
+}
+
+float TentacleBank::blockSegmentLength(int b) const {
+    // Coarser tiers keep the chain's total rest length.
+    const TentacleArchetype& params = archetypes[blockArchetype[b]];
+    const int n = blockSegments[b];
+    if (n == params.segments || n < 2) return params.segmentLength;
+    return params.segmentLength * static_cast<float>(params.segments - 1) / static_cast<float>(n - 1);
+}
+
+Vector3 TentacleBank::Position(int t, int i) const {
+    return point(slotOf[t], i);
+}
+
+Vector3 TentacleBank::point(int s, int i) const {
+    const std::size_t k = at(s, i);
+    return {x[k], y[k], z[k]};
+}
+
+Vector3 TentacleBank::RenderPosition(int t, int i, float alpha) const {
+    const std::size_t k = at(slotOf[t], i);
+    return {
+        tickX[k] + (x[k] - tickX[k]) * alpha,
+        tickY[k] + (y[k] - tickY[k]) * alpha,
+        tickZ[k] + (z[k] - tickZ[k]) * alpha
+    };
+}
+
+void TentacleBank::updateLod(int b, const Core& core) {
+    const TentacleArchetype& params = archetypes[blockArchetype[b]];
+    const int archetype = blockArchetype[b];
+    int target = 0;
+    float wanted = static_cast<float>(params.segments);
+    if (lod.forcedTier >= 0) {
+        target = std::min(lod.forcedTier, LOD_TIERS - 1);
+    } else {
+        // Longest projected chain in the block decides; padding lanes do not
+        // count.
+        const int first = b * LANES;
+        const int last = first + blockLanes[b];
+        const int n = blockSegments[b];
+        const float margin = params.segmentLength * static_cast<float>(params.segments);
+        const bool cull = lod.viewWidth > 0.0f && lod.viewHeight > 0.0f;
+        float longest = 0.0f;
+        bool visible = !cull;
+        // About eight joints per chain are enough to measure it.
+        const int stride = std::max(1, (n - 1) / 8);
+        const auto onScreen = [&](Vector2 p) {
+            return p.x > -margin && p.y > -margin && p.x < lod.viewWidth + margin && p.y < lod.viewHeight + margin;
+        };
+        for (int t = first; t < last; ++t) {
+            const ScreenPoint root = ProjectPoint(core.pos, point(t, 0));
+            ScreenPoint prev = root;
+            float length = 0.0f;
+            for (int i = stride; i < n; i = (i == n - 1) ? n : std::min(i + stride, n - 1)) {
+                const ScreenPoint p = ProjectPoint(core.pos, point(t, i));
+                length += Vector2Distance(prev.pos, p.pos);
+                prev = p;
+            }
+            longest = std::max(longest, length);
+            if (cull && !visible) {
+                visible = onScreen(root.pos) || onScreen(prev.pos);
+            }
+        }
+        wanted = visible ? longest / fmaxf(lod.pixelsPerSegment, 1.0f) * lodScale + 1.0f : 0.0f;
+        // Coarsest tier that still gives every segment at most
+        // pixelsPerSegment of screen length.
+        target = 0;
+        while (target + 1 < LOD_TIERS && static_cast<float>(TierSegments(target + 1, archetype)) >= wanted) {
+            ++target;
+        }
+    }
+
+    int tier = blockTier[b];
+    ++blockDwell[b];
+    if (target < tier || lod.forcedTier >= 0) {
+        // Refine straight away; missing detail is what pops. A forced tier
+        // has no threshold to flip around, so it applies at once too.
+        tier = target;
+    } else if (target > tier && blockDwell[b] >= lod.minDwellSteps) {
+        // Coarsen one tier at a time, and only with some headroom, so blocks
+        // near a threshold do not flip back and forth.
+        if (static_cast<float>(TierSegments(tier + 1, archetype)) >= wanted * 1.2f) {
+            tier = tier + 1;
+        }
+    }
+    if (tier == blockTier[b]) return;
+
+    blockTier[b] = tier;
+    blockDwell[b] = 0;
+    const int segments = TierSegments(tier, archetype);
+    if (segments != blockSegments[b]) {
+        resampleBlock(b, segments);
+    }
+}
+
+void TentacleBank::resampleBlock(int b, int segments) {
+    // Place the new joints at even arc-length steps along the current chain
+    // and interpolate every state array at the same points. Root and tip land
+    // exactly on old joints, and velocity (position minus previous position)
+    // is interpolated with the positions, so the tip keeps both.
+    const int n = blockSegments[b];
+    if (n < 2 || segments < 2) {
+        blockSegments[b] = segments;
+        return;
+    }
+    AlignedVector<float>* arrays[] = {&x,     &y,     &z,     &prevX,  &prevY,  &prevZ,
+                                      &tickX, &tickY, &tickZ, &driftX, &driftY, &driftZ};
+    float arc[MAX_CHAIN_SEGMENTS];
+    float resampled[MAX_CHAIN_SEGMENTS];
+    int from[MAX_CHAIN_SEGMENTS];
+    float frac[MAX_CHAIN_SEGMENTS];
+    for (int t = b * LANES; t < (b + 1) * LANES; ++t) {
+        arc[0] = 0.0f;
+        for (int i = 1; i < n; ++i) {
+            arc[i] = arc[i - 1] + Vector3Distance(point(t, i - 1), point(t, i));
+        }
+        const float total = arc[n - 1];
+        int seg = 0;
+        for (int j = 0; j < segments; ++j) {
+            if (j == segments - 1 || total <= 0.0f) {
+                // Pin the tip (or map evenly by index on a collapsed chain).
+                const float u = segments > 1 ? static_cast<float>(j) * (n - 1) / (segments - 1) : 0.0f;
+                from[j] = std::min(static_cast<int>(u), n - 2);
+                frac[j] = u - static_cast<float>(from[j]);
+                continue;
+            }
+            const float target = total * static_cast<float>(j) / static_cast<float>(segments - 1);
+            while (seg < n - 2 && arc[seg + 1] < target) ++seg;
+            const float span = arc[seg + 1] - arc[seg];
+            from[j] = seg;
+            frac[j] = span > 0.0f ? std::clamp((target - arc[seg]) / span, 0.0f, 1.0f) : 0.0f;
+        }
+        for (AlignedVector<float>* array : arrays) {
+            AlignedVector<float>& v = *array;
+            for (int j = 0; j < segments; ++j) {
+                const float a = v[at(t, from[j])];
+                const float c = v[at(t, from[j] + 1)];
+                resampled[j] = frac[j] >= 1.0f ? c : a + (c - a) * frac[j];
+            }
+            for (int j = 0; j < segments; ++j) {
+                v[at(t, j)] = resampled[j];
+            }
+        }
+    }
+    blockSegments[b] = segments;
+}
+
+void TentacleBank::Update(float dt, double timeMs, bool isActive, const AnchorRing& ring, Core& core, JobSystem* jobs) {
+    if (count == 0) return;
+    const double seconds = timeMs * 0.001;
+
+    tickX = x;
+    tickY = y;
+    tickZ = z;
+
+    // Anchors repel each other, so every tentacle reads its neighbours from
+    // last step's snapshot; results then do not depend on update order.
+    anchorAngleRead = anchorAngle;
+    sortAnchors();
+
+    // One set of step constants per archetype, shared by all its blocks.
+    std::array<ChainBlock, MAX_ARCHETYPES> steps{};
+    std::array<bool, MAX_ARCHETYPES> wake{};
+    const float coreSpeed = sqrtf(core.vx * core.vx + core.vy * core.vy);
+    for (std::size_t a = 0; a < archetypes.size(); ++a) {
+        const TentacleArchetype& params = archetypes[a];
+        ChainBlock& step = steps[a];
+        step.laneStride = LANES;
+        step.segments = params.segments;
+        // Gains are tuned per 60 Hz frame; rescale them for the actual step.
+        const float frames = dt * 60.0f;
+        step.damp = powf(params.airDamping, frames);
+        step.keep = powf(1.0f - params.frictionStrength, frames);
+        step.segmentLength = params.segmentLength;
+        step.bendStiffness = params.bendStiffness;
+        step.zBias = params.zBias;
+        step.waveAmp = isActive ? params.waveAmpActive : params.waveAmpIdle;
+        // Wrapped in double before narrowing: the phase grows without bound
+        // and SinCos is only accurate for small arguments.
+        const double waveSpeed = isActive ? params.waveSpeedActive : params.waveSpeedIdle;
+        step.wavePhase = static_cast<float>(std::fmod(seconds * waveSpeed, 2.0 * std::numbers::pi));
+        step.wavePhaseOffset = params.wavePhaseOffset;
+        step.minRadius = attachRadius + params.collisionPad;
+        step.coreX = core.pos.x;
+        step.coreY = core.pos.y;
+        step.coreZ = core.pos.z;
+        step.xpbd = model == ConstraintModel::Xpbd;
+        step.direct = distanceSolver == DistanceSolver::Direct;
+        step.distanceAlpha = params.distanceCompliance / (dt * dt);
+        step.bendAlpha = params.bendCompliance / (dt * dt);
+        // Anything that drives the chains from outside wakes the species.
+        wake[a] = isActive || coreSpeed > params.wakeCoreSpeed;
+    }
+
+    // Spread the segment budget evenly over what the bank would run at full
+    // detail.
+    lodScale = 1.0f;
+    if (lod.segmentBudget > 0) {
+        const float full = static_cast<float>(FullDetailSegments());
+        lodScale = std::min(1.0f, static_cast<float>(lod.segmentBudget) / full);
+    }
+
+    const int blocks = paddedCount / LANES;
+    for (int b = 0; b < blocks; ++b) {
+        if (wake[blockArchetype[b]]) blockCalmSteps[b] = 0;
+    }
+    blockAV.assign(blocks, 0.0f);
+    auto runBlocks = [&](int begin, int end) {
+        for (int b = begin; b < end; ++b) {
+            updateBlock(b, steps[blockArchetype[b]], dt, ring, core);
+        }
+    };
+    if (jobs) {
+        const int grain = std::max(1, blocks / static_cast<int>(jobs->ThreadCount() * 8));
+        jobs->ParallelFor(blocks, grain, runBlocks);
+    } else {
+        runBlocks(0, blocks);
+    }
+
+    // Sum per-block partials in block order so the result is identical for
+    // any thread count.
+    for (float partial : blockAV) {
+        core.avAccum += partial;
+    }
+    core.avCount += count;
+
+    solverStats = {};
+    solverStats.minPasses = blockPasses[0];
+    long long passes = 0;
+    for (int b = 0; b < blocks; ++b) {
+        passes += static_cast<long long>(blockPasses[b]) * blockLanes[b];
+        solverStats.minPasses = std::min(solverStats.minPasses, blockPasses[b]);
+        solverStats.maxPasses = std::max(solverStats.maxPasses, blockPasses[b]);
+        solverStats.maxResidual = std::max(solverStats.maxResidual, blockResidual[b]);
+    }
+    solverStats.meanPasses = static_cast<float>(passes) / static_cast<float>(count);
+}
+
+void TentacleBank::sortAnchors() {
+    // Anchors drift only slightly per step, so the previous order is almost
+    // sorted and insertion sort finishes in about one pass. A large
+    // reshuffle (first step, big jumps) falls back to a full sort.
+    const auto angleLess = [this](int a, int b) { return anchorAngleRead[a] < anchorAngleRead[b]; };
+    long long budget = 4LL * count;
+    bool sorted = true;
+    for (int i = 1; i < count && sorted; ++i) {
+        const int item = anchorOrder[i];
+        int j = i - 1;
+        while (j >= 0 && angleLess(item, anchorOrder[j])) {
+            anchorOrder[j + 1] = anchorOrder[j];
+            --j;
+            if (--budget < 0) {
+                sorted = false;
+                break;
+            }
+        }
+        anchorOrder[j + 1] = item;
+    }
+    if (!sorted) {
+        std::sort(anchorOrder.begin(), anchorOrder.end(), angleLess);
+    }
+    for (int i = 0; i < count; ++i) {
+        anchorRank[anchorOrder[i]] = i;
+    }
+}
+
+void TentacleBank::updateBlock(int b, const ChainBlock& step, float dt, const AnchorRing& ring, const Core& core) {
+    const TentacleArchetype& params = archetypes[blockArchetype[b]];
+    const int first = b * LANES;
+    const int last = first + blockLanes[b];
+    // A held chain only turns about the core, which leaves its projected
+    // length alone, so a sleeping block keeps its tier.
+    if (!blockAsleep[b]) updateLod(b, core);
+
+    ChainBlock block = step;
+    block.segments = blockSegments[b];
+    block.segmentLength = blockSegmentLength(b);
+    if (block.segments != step.segments) {
+        // Keep the same number of wave cycles along the chain.
+        block.wavePhaseOffset = step.wavePhaseOffset * block.segmentLength / step.segmentLength;
+    }
+    // A neighbour pushing an anchor shows up as a change in its angular
+    // velocity; a steady spin does not disturb the chain's shape.
+    const float frames = dt * 60.0f;
+    const float anchorLimit = params.wakeAnchorAccel * frames;
+    bool anchorsMoving = false;
+    float avSum = 0.0f;
+    alignas(64) float turnCos[LANES];
+    alignas(64) float turnSin[LANES];
+    for (int lane = 0; lane < LANES; ++lane) {
+        turnCos[lane] = 1.0f;
+        turnSin[lane] = 0.0f;
+    }
+    for (int t = first; t < last; ++t) {
+        const float before = anchorAV[t];
+        updateAnchor(t, dt, ring, core);
+        avSum += anchorAV[t];
+        if (fabsf(anchorAV[t] - before) > anchorLimit) anchorsMoving = true;
+        SinCos(anchorAV[t] * dt, turnSin[t - first], turnCos[t - first]);
+    }
+    blockAV[b] = avSum;
+    const bool asleep = !anchorsMoving && blockCalmSteps[b] >= params.sleepDelaySteps;
+    const ChainKernels kernels = ChainKernelsFor(isa);
+    bindLanes(block, first);
+    if (asleep) {
+        // A block falling asleep keeps its current shape, swayed from the
+        // current phase on. Sleeping chains are carried round with their
+        // anchors and swayed by the wave; only the wake tests above can end
+        // it.
+        if (!blockAsleep[b]) {
+            for (int i = 0; i < block.segments; ++i) {
+                const std::size_t k = at(first, i);
+                std::copy_n(x.data() + k, LANES, heldX.data() + k);
+                std::copy_n(y.data() + k, LANES, heldY.data() + k);
+            }
+            blockHeldPhase[b] = step.wavePhase;
+        }
+        blockAsleep[b] = 1;
+        block.heldPhase = blockHeldPhase[b];
+        kernels.hold(block, turnCos, turnSin);
+        blockPasses[b] = 0;
+        blockResidual[b] = 0.0f;
+        return;
+    }
+    blockAsleep[b] = 0;
+
+    // Every lane of the block runs the same number of passes, decided on the
+    // real tentacles only, so both paths stop together at any SIMD width.
+    // A sweep carries a correction one link per pass, so a coarser tier
+    // converges in proportionally fewer passes and gets a smaller cap.
+    int maxPasses = lod.maxIterations > 0 ? std::min(params.maxIterations, lod.maxIterations) : params.maxIterations;
+    if (block.segments < params.segments) {
+        const int scaled = (maxPasses * block.segments + params.segments - 1) / params.segments;
+        maxPasses = std::min(maxPasses, std::max(scaled, params.minIterations));
+    }
+    const int minPasses = std::min(params.minIterations, maxPasses);
+    const float tolerance = params.residualTolerance * block.segmentLength;
+    alignas(64) float curvature[MAX_CHAIN_SEGMENTS * LANES];
+    alignas(64) float distanceLambda[MAX_CHAIN_SEGMENTS * LANES];
+    alignas(64) float bendLambda[MAX_CHAIN_SEGMENTS * LANES];
+    alignas(64) float laneResidual[LANES];
+    const bool scalar = solverPath == SolverPath::Scalar;
+    block.curvature = curvature;
+    block.distanceLambda = distanceLambda;
+    block.bendLambda = bendLambda;
+    if (scalar) {
+        for (int t = first; t < last; ++t) {
+            integrateChainScalar(t, block);
+        }
+    } else {
+        kernels.integrate(block);
+    }
+    int passes = 0;
+    float residual = 0.0f;
+    while (passes < maxPasses) {
+        if (scalar) {
+            for (int t = first; t < last; ++t) {
+                laneResidual[t - first] = relaxChainScalar(t, block, core);
+            }
+        } else {
+            kernels.relax(block, laneResidual);
+        }
+        ++passes;
+        residual = 0.0f;
+        for (int t = first; t < last; ++t) {
+            residual = std::max(residual, laneResidual[t - first]);
+        }
+        if (passes >= minPasses && residual < tolerance) break;
+    }
+    blockPasses[b] = passes;
+    blockResidual[b] = residual / block.segmentLength;
+
+    kernels.measure(block, turnCos, turnSin, kineticEnergy.data() + first, stretchError.data() + first);
+    // Energy is a change of velocity per step; compare it per 60 Hz frame.
+    const float frames2 = frames * frames;
+    const float energyLimit = params.sleepEnergy * frames2 * frames2;
+    // The stretch a full solve leaves depends on how hard the ring and wave
+    // pull, so each chain is judged against its own recent average.
+    const float smoothing = 1.0f / static_cast<float>(std::max(params.sleepDelaySteps, 1));
+    bool calm = !anchorsMoving;
+    for (int t = first; t < last; ++t) {
+        const float errorLimit = std::max(params.sleepError, drivenError[t]) * params.wakeFactor;
+        calm = calm && kineticEnergy[t] < energyLimit && stretchError[t] < errorLimit;
+        drivenError[t] += (stretchError[t] - drivenError[t]) * smoothing;
+    }
+    blockCalmSteps[b] = calm ? std::min(blockCalmSteps[b] + 1, params.sleepDelaySteps) : 0;
+}
+
+void TentacleBank::bindLanes(ChainBlock& block, int lane) {
+    const std::size_t base = at(lane, 0);
+    block.x = x.data() + base;
+    block.y = y.data() + base;
+    block.z = z.data() + base;
+    block.prevX = prevX.data() + base;
+    block.prevY = prevY.data() + base;
+    block.prevZ = prevZ.data() + base;
+    block.driftX = driftX.data() + base;
+    block.driftY = driftY.data() + base;
+    block.driftZ = driftZ.data() + base;
+    block.heldX = heldX.data() + base;
+    block.heldY = heldY.data() + base;
+    block.attachX = attachX.data() + lane;
+    block.attachY = attachY.data() + lane;
+    block.attachZ = attachZ.data() + lane;
+    block.attachVX = attachVX.data() + lane;
+    block.attachVY = attachVY.data() + lane;
+    block.anchorCos = anchorCos.data() + lane;
+    block.anchorSin = anchorSin.data() + lane;
+    block.coreGain = coreGain.data() + lane;
+    block.animationSeed = animationSeed.data() + lane;
+}
+
+void TentacleBank::updateAnchor(int t, float dt, const AnchorRing& ring, const Core& core) {
+    const TentacleArchetype& params = archetypeOfSlot(t);
+    const int n = blockSegments[t / LANES];
+    float& angle = anchorAngle[t];
+    float& av = anchorAV[t];
+    float tx, ty;
+    SinCos(angle, tx, ty);
+    tx = -tx;
+    const float baseRadius = fmaxf(attachRadius, 1.0f);
+    const float coreTang = (core.vx * tx + core.vy * ty) / baseRadius;
+    coreTangentialVelocity[t] = coreTang;
+
+    float tension = 0.0f;
+    if (n > 1) {
+        const std::size_t k = at(t, 1);
+        tension = ((x[k] - lastAttachX[t]) * tx + (y[k] - lastAttachY[t]) * ty) / fmaxf(blockSegmentLength(t / LANES), 1.0f);
+    }
+
+    const float frames = dt * 60.0f;
+    const float afr = powf(params.anchorFriction, frames);
+    av = (av + (params.anchorCoreInfluence * coreTang + params.anchorTensionInfluence * tension) * frames) * afr;
+
+    const float targetAngle = baseAngle[t] + ring.offset;
+    float spacingError = ClampAngle(targetAngle - angle);
+    const float spacingGain = 0.8f;
+    av += spacingError * spacingGain * frames;
+
+    // Repulsion only reaches anchors closer than the window, so walk the
+    // sorted ring outwards from this anchor in both directions and stop at
+    // the first one out of range. Contributions are applied in index order
+    // to match an all-pairs scan exactly.
+    const float repulsionStrength = 0.5f;
+    const float minAngle = PI2 / static_cast<float>(count);
+    const float window = minAngle * 0.8f;
+    thread_local std::vector<int> nearby;
+    nearby.clear();
+    const int rank = anchorRank[t];
+    int forward = 0;
+    for (int k = 1; k < count; ++k) {
+        const int o = anchorOrder[(rank + k) % count];
+        const float diff = ClampAngle(anchorAngleRead[o] - angle);
+        if (diff < 0.0f || diff >= window) break;
+        nearby.push_back(o);
+        forward = k;
+    }
+    for (int k = 1; k < count - forward; ++k) {
+        const int o = anchorOrder[(rank - k + count) % count];
+        const float diff = ClampAngle(anchorAngleRead[o] - angle);
+        if (diff > 0.0f || -diff >= window) break;
+        nearby.push_back(o);
+    }
+    std::sort(nearby.begin(), nearby.end());
+    for (int o : nearby) {
+        float diff = ClampAngle(anchorAngleRead[o] - angle);
+        float sign = diff > 0 ? 1.0f : -1.0f;
+        av -= sign * repulsionStrength * (window - fabsf(diff)) / window * frames;
+    }
+
+    av = std::clamp(av, -params.anchorMaxAV, params.anchorMaxAV);
+
+    angle = ClampAngle(angle + av * dt);
+
+    float s, c;
+    SinCos(angle, s, c);
+    attachX[t] = core.pos.x + c * attachRadius;
+    attachY[t] = core.pos.y + s * attachRadius;
+    attachZ[t] = 0.0f;
+    attachVX[t] = attachX[t] - lastAttachX[t];
+    attachVY[t] = attachY[t] - lastAttachY[t];
+    anchorCos[t] = c;
+    anchorSin[t] = s;
+    coreGain[t] = std::clamp(0.8f + 0.6f * fabsf(coreTang), 0.8f, 1.6f);
+
+    lastAttachX[t] = attachX[t];
+    lastAttachY[t] = attachY[t];
+    lastAttachZ[t] = attachZ[t];
+}
+
+void TentacleBank::integrateChainScalar(int t, const ChainBlock& step) {
+    const int n = step.segments;
+    const std::size_t s = LANES;
+    const std::size_t base = at(t, 0);
+    float* px = x.data() + base;
+    float* py = y.data() + base;
+    float* pz = z.data() + base;
+    float* qx = prevX.data() + base;
+    float* qy = prevY.data() + base;
+    float* qz = prevZ.data() + base;
+
+    const float damp = step.damp;
+    px[0] = qx[0] = attachX[t];
+    py[0] = qy[0] = attachY[t];
+    pz[0] = qz[0] = attachZ[t];
+
+    const float keep = step.keep;
+    for (int i = 1; i < n; ++i) {
+        const std::size_t k = i * s;
+        float vx = (px[k] - qx[k]) * damp;
+        float vy = (py[k] - qy[k]) * damp;
+        float vz = (pz[k] - qz[k]) * damp;
+        qx[k] = px[k];
+        qy[k] = py[k];
+        qz[k] = pz[k];
+        px[k] += vx * keep;
+        py[k] += vy * keep;
+        pz[k] += vz * keep;
+    }
+
+    if (n > 2) {
+        px[s] += attachVX[t] * CHAIN_GAINS.attachKick1;
+        py[s] += attachVY[t] * CHAIN_GAINS.attachKick1;
+        px[2 * s] += attachVX[t] * CHAIN_GAINS.attachKick2;
+        py[2 * s] += attachVY[t] * CHAIN_GAINS.attachKick2;
+    }
+
+    const std::size_t lane = t % LANES;
+    float stepSin, stepCos;
+    SinCos(0.0f - step.wavePhaseOffset, stepSin, stepCos);
+    Phasor<F32x1> wave = Phasor<F32x1>::Start(F32x1::Set(step.wavePhase - step.wavePhaseOffset + animationSeed[t]));
+    for (int i = 1; i + 1 < n; ++i) {
+        const float idxT = static_cast<float>(i) / static_cast<float>(n - 1);
+        const float env = CHAIN_GAINS.waveEnvelopeRoot + (CHAIN_GAINS.waveEnvelopeTip - CHAIN_GAINS.waveEnvelopeRoot) * idxT;
+        step.curvature[i * s + lane] = step.waveAmp * env * coreGain[t] * wave.sin.v * step.segmentLength;
+        wave.Advance(F32x1::Set(stepSin), F32x1::Set(stepCos));
+    }
+
+    if (step.xpbd) {
+        for (int i = 0; i < n; ++i) {
+            step.distanceLambda[i * s + lane] = 0.0f;
+            step.bendLambda[i * s + lane] = 0.0f;
+        }
+    }
+}
+
+float TentacleBank::relaxChainScalar(int t, const ChainBlock& step, const Core& core) {
+    const int n = step.segments;
+    const std::size_t s = LANES;
+    const std::size_t base = at(t, 0);
+    float* px = x.data() + base;
+    float* py = y.data() + base;
+    float* pz = z.data() + base;
+
+    const float segmentLength = step.segmentLength;
+    const float rootX = attachX[t];
+    const float rootY = attachY[t];
+    const float rootZ = attachZ[t];
+    const float minRadius = step.minRadius;
+    const Vector3 corePos = core.pos;
+    const Vector3 fallback{anchorCos[t], anchorSin[t], 0.0f};
+
+    float* distanceLambda = step.distanceLambda + t % LANES;
+    float* bendLambda = step.bendLambda + t % LANES;
+
+    float residual = 0.0f;
+    // distance constraints
+    if (step.direct) {
+        residual = directDistancesScalar(t, step);
+    } else {
+        ChainResidual<F32x1> sweep(step);
+        for (int i = 1; i < n; ++i) {
+            const std::size_t ka = (i - 1) * s, kb = i * s;
+            float dx = px[kb] - px[ka];
+            float dy = py[kb] - py[ka];
+            float dz = pz[kb] - pz[ka];
+            const float dist2 = dx * dx + dy * dy + dz * dz;
+            const bool tiny = dist2 < 1e-8f;
+            const float inv = tiny ? 1.0f : Rsqrt(dist2);
+            const float dist = tiny ? 1.0f : dist2 * inv;
+            sweep.Add(F32x1::Set(dist - segmentLength), F32x1::Set(px[kb]), F32x1::Set(py[kb]), F32x1::Set(pz[kb]));
+            if (step.xpbd) {
+                // The root is fixed, so the first segment moves only its child.
+                const float lambda = distanceLambda[kb];
+                const float weight = i == 1 ? 1.0f : 2.0f;
+                const float dl = (0.0f - (dist - segmentLength) - step.distanceAlpha * lambda) / (weight + step.distanceAlpha);
+                distanceLambda[kb] = lambda + dl;
+                const float scale = dl * inv;
+                const float cx = dx * scale;
+                const float cy = dy * scale;
+                const float cz = dz * scale;
+                px[kb] += cx;
+                py[kb] += cy;
+                pz[kb] += cz;
+                if (i > 1) {
+                    px[ka] -= cx;
+                    py[ka] -= cy;
+                    pz[ka] -= cz;
+                }
+                continue;
+            }
+            float diff = (dist - segmentLength) * inv;
+            if (i == 1) {
+                px[kb] -= dx * diff * CHAIN_GAINS.rootCorrection;
+                py[kb] -= dy * diff * CHAIN_GAINS.rootCorrection;
+                pz[kb] -= dz * diff * CHAIN_GAINS.rootCorrection;
+            } else {
+                float cx = dx * diff * 0.5f;
+                float cy = dy * diff * 0.5f;
+                float cz = dz * diff * 0.5f;
+                px[ka] += cx;
+                py[ka] += cy;
+                pz[ka] += cz;
+                px[kb] -= cx;
+                py[kb] -= cy;
+                pz[kb] -= cz;
+            }
+        }
+        residual = sweep.Mean().v;
+    }
+    px[0] = rootX;
+    py[0] = rootY;
+    pz[0] = rootZ;
+
+    // bend stiffness & wave
+    for (int i = 1; i + 1 < n; ++i) {
+        const std::size_t k0 = (i - 1) * s, k1 = i * s, k2 = (i + 1) * s;
+        Vector3 p0{px[k0], py[k0], pz[k0]};
+        Vector3 p1{px[k1], py[k1], pz[k1]};
+        Vector3 p2{px[k2], py[k2], pz[k2]};
+
+        Vector3 mid{(p0.x + p2.x) * 0.5f, (p0.y + p2.y) * 0.5f, (p0.z + p2.z) * 0.5f};
+        Vector3 tangent = Vector3Subtract(p2, p0);
+        const float tlen2 = Vector3DotProduct(tangent, tangent);
+        if (tlen2 < 1e-8f) {
+            tangent = {0.0f, 1.0f, 0.0f};
+        } else {
+            tangent = Vector3Scale(tangent, Rsqrt(tlen2));
+        }
+        Vector3 radial = Vector3Subtract(p1, corePos);
+        float dotTR = Vector3DotProduct(radial, tangent);
+        Vector3 normal = Vector3Subtract(radial, Vector3Scale(tangent, dotTR));
+        normal.z += step.zBias * segmentLength;
+        const float nlen2 = Vector3DotProduct(normal, normal);
+        if (nlen2 < 1e-8f) {
+            normal = {0.0f, 0.0f, 1.0f};
+        } else {
+            normal = Vector3Scale(normal, Rsqrt(nlen2));
+        }
+
+        Vector3 target = Vector3Add(mid, Vector3Scale(normal, step.curvature[k1 + t % LANES]));
+        if (step.xpbd) {
+            // C = |p1 - target|, pulling p1 alone towards the target.
+            const Vector3 e{p1.x - target.x, p1.y - target.y, p1.z - target.z};
+            const float err = sqrtf(e.x * e.x + e.y * e.y + e.z * e.z);
+            const bool moved = 1e-4f < err;
+            const float lambda = bendLambda[k1];
+            const float dl = moved ? (0.0f - err - step.bendAlpha * lambda) / (1.0f + step.bendAlpha) : 0.0f;
+            bendLambda[k1] = lambda + dl;
+            const float scale = dl / (moved ? err : 1.0f);
+            px[k1] += e.x * scale;
+            py[k1] += e.y * scale;
+            pz[k1] += e.z * scale;
+        } else {
+            px[k1] += (target.x - p1.x) * step.bendStiffness;
+            py[k1] += (target.y - p1.y) * step.bendStiffness;
+            pz[k1] += (target.z - p1.z) * step.bendStiffness;
+        }
+    }
+
+    // collision with orb
+    for (int j = 1; j < n; ++j) {
+        const std::size_t k = j * s;
+        Vector3 delta{px[k] - corePos.x, py[k] - corePos.y, pz[k] - corePos.z};
+        float dist = Vector3Length(delta);
+        if (dist < minRadius) {
+            if (dist < 1e-4f) {
+                delta = fallback;
+                dist = 1.0f;
+            }
+            Vector3 normal = Vector3Scale(delta, 1.0f / dist);
+            px[k] = corePos.x + normal.x * minRadius;
+            py[k] = corePos.y + normal.y * minRadius;
+            pz[k] = corePos.z + normal.z * minRadius;
+        }
+    }
+    // segment-line collision vs orb
+    for (int j = 1; j < n; ++j) {
+        const std::size_t ka = (j - 1) * s, kb = j * s;
+        Vector3 a{px[ka], py[ka], pz[ka]};
+        Vector3 v{px[kb] - a.x, py[kb] - a.y, pz[kb] - a.z};
+        float denom = Vector3DotProduct(v, v);
+        if (denom < 1e-5f) continue;
+        Vector3 w = Vector3Subtract(corePos, a);
+        float u = std::clamp(Vector3DotProduct(v, w) / denom, 0.0f, 1.0f);
+        Vector3 delta{a.x + v.x * u - corePos.x, a.y + v.y * u - corePos.y, a.z + v.z * u - corePos.z};
+        float dist = Vector3Length(delta);
+        if (dist < minRadius) {
+            if (dist < 1e-4f) {
+                delta = fallback;
+                dist = 1.0f;
+            }
+            Vector3 normal = Vector3Scale(delta, 1.0f / dist);
+            float push = (minRadius - dist);
+            px[kb] += normal.x * push;
+            py[kb] += normal.y * push;
+            pz[kb] += normal.z * push;
+            if (j > 1) {
+                px[ka] += normal.x * push * CHAIN_GAINS.innerPush;
+                py[ka] += normal.y * push * CHAIN_GAINS.innerPush;
+                pz[ka] += normal.z * push * CHAIN_GAINS.innerPush;
+            }
+        }
+    }
+    px[0] = rootX;
+    py[0] = rootY;
+    pz[0] = rootZ;
+    return residual;
+}
+
+float TentacleBank::directDistancesScalar(int t, const ChainBlock& step) {
+    // Scalar reference for DirectDistances in tentacle_kernels.hpp.
+    const int n = step.segments;
+    const std::size_t s = LANES;
+    const std::size_t base = at(t, 0);
+    float* px = x.data() + base;
+    float* py = y.data() + base;
+    float* pz = z.data() + base;
+    float* lambda = step.distanceLambda + t % LANES;
+    const float alpha = step.xpbd ? step.distanceAlpha : 0.0f;
+    const float maxStep = CHAIN_GAINS.directMaxStep * step.segmentLength;
+
+    float nx[MAX_CHAIN_SEGMENTS];
+    float ny[MAX_CHAIN_SEGMENTS];
+    float nz[MAX_CHAIN_SEGMENTS];
+    float upper[MAX_CHAIN_SEGMENTS];
+    float rhs[MAX_CHAIN_SEGMENTS];
+    ChainResidual<F32x1> residual(step);
+    for (int i = 1; i < n; ++i) {
+        const std::size_t ka = (i - 1) * s, kb = i * s;
+        const float dx = px[kb] - px[ka];
+        const float dy = py[kb] - py[ka];
+        const float dz = pz[kb] - pz[ka];
+        const float dist2 = dx * dx + dy * dy + dz * dz;
+        const bool tiny = dist2 < 1e-8f;
+        const float inv = tiny ? 1.0f : Rsqrt(dist2);
+        const float dist = tiny ? 1.0f : dist2 * inv;
+        const float stretch = dist - step.segmentLength;
+        residual.Add(F32x1::Set(stretch), F32x1::Set(px[kb]), F32x1::Set(py[kb]), F32x1::Set(pz[kb]));
+        nx[i] = dx * inv;
+        ny[i] = dy * inv;
+        nz[i] = dz * inv;
+        rhs[i] = 0.0f - stretch;
+        if (step.xpbd) rhs[i] = rhs[i] - alpha * lambda[kb];
+    }
+
+    for (int i = 1; i < n; ++i) {
+        float diag = (i == 1 ? 1.0f : 2.0f) + alpha;
+        if (i > 1) {
+            const float lower = 0.0f - (nx[i - 1] * nx[i] + ny[i - 1] * ny[i] + nz[i - 1] * nz[i]);
+            diag = diag - lower * upper[i - 1];
+            rhs[i] = rhs[i] - lower * rhs[i - 1];
+        }
+        const float inv = 1.0f / diag;
+        upper[i] = i + 1 < n ? (0.0f - (nx[i] * nx[i + 1] + ny[i] * ny[i + 1] + nz[i] * nz[i + 1])) * inv : 0.0f;
+        rhs[i] = rhs[i] * inv;
+    }
+
+    float next = 0.0f;
+    for (int i = n - 1; i >= 1; --i) {
+        const std::size_t k = i * s;
+        const float dl = std::min(std::max(rhs[i] - upper[i] * next, 0.0f - maxStep), maxStep);
+        if (step.xpbd) lambda[k] = lambda[k] + dl;
+        float mx = nx[i] * dl;
+        float my = ny[i] * dl;
+        float mz = nz[i] * dl;
+        if (i + 1 < n) {
+            mx = mx - nx[i + 1] * next;
+            my = my - ny[i + 1] * next;
+            mz = mz - nz[i + 1] * next;
+        }
+        px[k] = px[k] + mx;
+        py[k] = py[k] + my;
+        pz[k] = pz[k] + mz;
+        next = dl;
+    }
+    return residual.Mean().v;
+}
+
+void TentacleBank::CollectChains(Vector3 origin, float alpha, ChainDrawBatch& batch) const {
+    const int blocks = static_cast<int>(blockSegments.size());
+    std::size_t total = 0;
+    int chains = 0;
+    for (int b = 0; b < blocks; ++b) {
+        total += static_cast<std::size_t>(blockLanes[b]) * blockSegments[b];
+        chains += blockLanes[b];
+    }
+    if (batch.joints.size() < total) batch.joints.resize(total);
+    batch.start.resize(chains + 1);
+
+    // Per-block scratch, joint-major like the bank.
+    constexpr std::size_t scratch = static_cast<std::size_t>(MAX_CHAIN_SEGMENTS) * LANES;
+    alignas(64) float screenX[scratch];
+    alignas(64) float screenY[scratch];
+    alignas(64) float depth[scratch];
+    alignas(64) float width[scratch];
+    alignas(64) float depthAlpha[scratch];
+
+    int chain = 0;
+    int next = 0;
+    for (int b = 0; b < blocks; ++b) {
+        const int n = blockSegments[b];
+        const std::size_t base = at(b * LANES, 0);
+        ProjectionBlock block{};
+        block.x = x.data() + base;
+        block.y = y.data() + base;
+        block.z = z.data() + base;
+        block.fromX = tickX.data() + base;
+        block.fromY = tickY.data() + base;
+        block.fromZ = tickZ.data() + base;
+        block.laneStride = LANES;
+        block.segments = n;
+        block.alpha = alpha;
+        block.originX = origin.x;
+        block.originY = origin.y;
+        block.originZ = origin.z;
+        block.fadeDepth = attachRadius * 2.0f;
+        block.screenX = screenX;
+        block.screenY = screenY;
+        block.depth = depth;
+        block.width = width;
+        block.depthAlpha = depthAlpha;
+        ChainKernelsFor(isa).project(block);
+
+        for (int lane = 0; lane < blockLanes[b]; ++lane) {
+            batch.start[chain++] = next;
+            for (int i = 0; i < n; ++i) {
+                const std::size_t k = static_cast<std::size_t>(i) * LANES + lane;
+                batch.joints[next++] = {{screenX[k], screenY[k]}, depth[k], width[k], depthAlpha[k]};
+            }
+        }
+    }
+    batch.start[chain] = next;
+}
@@ -0,0 +1,374 @@
+#pragma once
+
+#include "cpu_features.hpp"
+
+#include <raylib.h>
+
+#include <cstddef>
+#include <new>
+#include <span>
+#include <vector>
+
+struct Core;
+struct AnchorRing;
+struct ChainBlock;
+class JobSystem;
+class Pcg32;
+
+// std::vector allocator that hands out cache-line aligned storage so every
+// tentacle row in the bank starts on its own line.
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+    void deallocate(T* p, std::size_t) { ::operator delete(p, std::align_val_t{Alignment}); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+};
+
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// A projected chain joint, ready to draw.
+struct JointDraw {
+    Vector2 pos{};
+    // World z; negative is behind the core.
+    float depth{0.0f};
+    float width{1.0f};
+    // Fades joints the further they are behind the core.
+    float depthAlpha{1.0f};
+};
+
+// One frame's projected chains, joint after joint: chain c owns
+// joints[start[c]] up to joints[start[c + 1]]. Kept between frames, so
+// collecting only allocates when the bank has more joints than ever before.
+struct ChainDrawBatch {
+    std::vector<JointDraw> joints;
+    std::vector<int> start;
+
+    int Chains() const { return start.empty() ? 0 : static_cast<int>(start.size()) - 1; }
+    std::span<const JointDraw> Chain(int c) const {
+        return {joints.data() + start[c], static_cast<std::size_t>(start[c + 1] - start[c])};
+    }
+};
+
+// Tuning shared by every tentacle of one species. The bank keeps one copy per
+// species and each tentacle refers to it through its block, so per-tentacle
+// storage holds only state.
+struct TentacleArchetype {
+    int segments{30};
+    // Constraint passes per step. Each pass measures every chain's mean
+    // distance residual (segments held against the orb left out, see
+    // ChainResidual); after minIterations the solve stops once the worst
+    // chain of the block is under residualTolerance (a fraction of the rest
+    // length), and it never runs more than maxIterations however hard the
+    // chains are pulled. The default holds the scripted drag at least as
+    // tight as four fixed passes while calm chains stop after two.
+    int minIterations{2};
+    int maxIterations{8};
+    float residualTolerance{0.4f};
+    // XPBD compliance (inverse stiffness) of the distance and bend
+    // constraints, used with ConstraintModel::Xpbd; 0 is rigid. The bend
+    // default moves a joint about as far per step as bendStiffness does over
+    // four PBD passes at 60 Hz, and keeps doing so at any pass count or rate.
+    float distanceCompliance{0.0f};
+    float bendCompliance{7.0e-4f};
+    float airDamping{0.995f};
+    float bendStiffness{0.08f};
+    float collisionPad{2.5f};
+    float waveAmpIdle{0.18f};
+    float waveAmpActive{0.33f};
+    float waveSpeedIdle{2.0f};
+    float waveSpeedActive{4.8f};
+    float wavePhaseOffset{0.45f};
+    float zBias{0.4f};
+    float frictionStrength{0.15f};
+    float segmentLength{10.0f};
+    float anchorFriction{0.9f};
+    float anchorCoreInfluence{0.6f};
+    float anchorTensionInfluence{0.15f};
+    float anchorMaxAV{6.0f};
+
+    // Sleep. A chain is calm while its joints accelerate by less than
+    // sleepEnergy (mean squared change of velocity, px per 60 Hz frame per
+    // frame, with the ring's spin taken out), so a chain swaying steadily in
+    // the idle wave on a spinning ring counts, and its stretch stays under
+    // wakeFactor times its own average (or sleepError, if that is larger).
+    // A block whose chains are all calm for sleepDelaySteps steps stops
+    // solving: its shape is carried round with its anchors and swayed by the
+    // idle wave analytically (HoldChainBlock). It wakes when an anchor's
+    // angular velocity changes by more than wakeAnchorAccel (rad/s per 60 Hz
+    // frame), when the core moves faster than wakeCoreSpeed (px per 60 Hz
+    // frame), when the wave turns active, or on Wake().
+    int sleepDelaySteps{45};
+    float sleepEnergy{1.0f};
+    float sleepError{0.03f};
+    float wakeFactor{3.0f};
+    float wakeAnchorAccel{0.05f};
+    float wakeCoreSpeed{0.05f};
+};
+
+// count tentacles of one archetype.
+struct TentacleGroup {
+    TentacleArchetype archetype;
+    int count{0};
+};
+
+// Level of detail. Each block of tentacles runs at one of LOD_TIERS segment
+// counts, picked from how long its chains are on screen (or forced). Chains
+// are resampled along their arc length on a change, so tips keep their
+// position and velocity.
+struct LodSettings {
+    // Fixed tier for every block, or -1 to choose from screen length.
+    int forcedTier{-1};
+    // Screen length each segment should cover at most.
+    float pixelsPerSegment{8.0f};
+    // Rough cap on simulated segments across the bank; 0 is unlimited.
+    int segmentBudget{0};
+    // Blocks entirely outside this view drop to the coarsest tier; 0 turns
+    // culling off.
+    float viewWidth{0.0f};
+    float viewHeight{0.0f};
+    // Steps a block stays at a tier before it may coarsen again.
+    int minDwellSteps{30};
+    // Caps every archetype's constraint passes per step; 0 leaves them as
+    // tuned.
+    int maxIterations{0};
+};
+
+// Constraint passes run by the last TentacleBank::Update. Sleeping blocks
+// run none.
+struct SolverStats {
+    int minPasses{0};
+    int maxPasses{0};
+    // Per tentacle.
+    float meanPasses{0.0f};
+    // Largest mean chain residual left when a block stopped, relative to
+    // rest length.
+    float maxResidual{0.0f};
+};
+
+// How constraints are projected. Pbd applies the tuned per-pass gains, so
+// stiffness shifts with the pass count and step rate; Xpbd takes compliances
+// and accumulates a Lagrange multiplier per constraint over each step, so the
+// same compliance feels the same however often it is solved.
+enum class ConstraintModel {
+    Pbd,
+    Xpbd
+};
+
+// How each pass resolves the distance constraints. GaussSeidel sweeps them
+// one at a time, so a long chain needs many passes to stop stretching; Direct
+// solves the linearised chain exactly (Thomas algorithm, O(segments)), so one
+// pass leaves it nearly inextensible.
+enum class DistanceSolver {
+    GaussSeidel,
+    Direct
+};
+
+// Which chain solver TentacleBank::Update runs. Scalar is the reference
+// implementation; Simd runs the lane-parallel kernels, built for the bank's
+// SimdIsa, and must agree with it.
+enum class SolverPath {
+    Scalar,
+    Simd
+};
+
+// Structure-of-arrays storage for every tentacle on the core. Tentacles are
+// grouped into blocks of LANES; inside a block segment i of all lanes is
+// contiguous, so element (t, i) lives at (block * capacity + i) * LANES + lane.
+// This keeps each block's rows tentacle-major while letting the kernels load
+// segment i of several tentacles with one aligned load.
+//
+// Each species starts on a block boundary, so every block solves a single
+// archetype with one set of gains. Public accessors take tentacle indices in
+// group order; internally a tentacle lives in a storage slot (slotOf), which
+// differs once a group's last block is padded.
+class TentacleBank {
+public:
+    static constexpr int LANES = 8;
+    static constexpr int LOD_TIERS = 4;
+    static constexpr int MAX_ARCHETYPES = 8;
+
+    void Init(const Core& core, int count, float attachRadius, Pcg32& rng, const TentacleArchetype& archetype = {});
+    // Several species on one core, interleaved around the ring. Groups past
+    // MAX_ARCHETYPES are dropped.
+    void Init(const Core& core, const std::vector<TentacleGroup>& groups, float attachRadius, Pcg32& rng);
+
+    // Advances every tentacle by dt. With a JobSystem, blocks are solved in
+    // parallel; the result is the same for any thread count.
+    void Update(float dt, double timeMs, bool isActive, const AnchorRing& ring, Core& core, JobSystem* jobs = nullptr);
+    // Projects the state blended alpha of the way from the previous step to
+    // the current one into batch, a block of lanes at a time with the
+    // kernels of the bank's SimdIsa.
+    void CollectChains(Vector3 origin, float alpha, ChainDrawBatch& batch) const;
+
+    // Wakes every sleeping block, e.g. when something outside the bank is
+    // about to disturb the chains.
+    void Wake();
+
+    void SetLod(const LodSettings& settings) { lod = settings; }
+    const LodSettings& GetLod() const { return lod; }
+    int TierSegments(int tier, int archetype = 0) const;
+
+    void SetSolverPath(SolverPath path) { solverPath = path; }
+    SolverPath GetSolverPath() const { return solverPath; }
+    // Instruction set of the Simd path; one the CPU lacks falls back to the
+    // widest supported narrower one.
+    void SetSimdIsa(SimdIsa value) { isa = SupportedSimdIsa(value); }
+    SimdIsa GetSimdIsa() const { return isa; }
+    int SimdWidth() const { return SimdIsaWidth(isa); }
+    void SetConstraintModel(ConstraintModel value) { model = value; }
+    ConstraintModel GetConstraintModel() const { return model; }
+    void SetDistanceSolver(DistanceSolver value) { distanceSolver = value; }
+    DistanceSolver GetDistanceSolver() const { return distanceSolver; }
+    // Overrides minIterations and maxIterations of every archetype.
+    void SetIterationRange(int minIterations, int maxIterations);
+
+    const SolverStats& GetSolverStats() const { return solverStats; }
+
+    int Count() const { return count; }
+    int ArchetypeCount() const { return static_cast<int>(archetypes.size()); }
+    const TentacleArchetype& Archetype(int a) const { return archetypes[a]; }
+    int ArchetypeOf(int t) const { return blockArchetype[slotOf[t] / LANES]; }
+    // Full-detail segment count of tentacle t; SegmentsOf() is what it runs
+    // at now.
+    int Segments(int t) const { return archetypes[ArchetypeOf(t)].segments; }
+    int SegmentsOf(int t) const { return blockSegments[slotOf[t] / LANES]; }
+    int TierOf(int t) const { return blockTier[slotOf[t] / LANES]; }
+    // Segments over all real tentacles at full detail, and simulated this
+    // step.
+    int FullDetailSegments() const;
+    int ActiveSegments() const;
+    // Tentacles held and swayed instead of solved this step.
+    int SleepingCount() const;
+    bool IsSleeping(int t) const { return blockAsleep[slotOf[t] / LANES] != 0; }
+    float KineticEnergy(int t) const { return kineticEnergy[slotOf[t]]; }
+    float StretchError(int t) const { return stretchError[slotOf[t]]; }
+    Vector3 Position(int t, int i) const;
+    Vector3 Tip(int t) const { return Position(t, SegmentsOf(t) - 1); }
+    Vector3 RenderPosition(int t, int i, float alpha) const;
+    Vector3 RenderTip(int t, float alpha) const { return RenderPosition(t, SegmentsOf(t) - 1, alpha); }
+    float AnchorAngle(int t) const { return anchorAngle[slotOf[t]]; }
+
+private:
+    void updateBlock(int b, const ChainBlock& step, float dt, const AnchorRing& ring, const Core& core);
+    void bindLanes(ChainBlock& block, int lane);
+    void updateLod(int b, const Core& core);
+    void resampleBlock(int b, int segments);
+    float blockSegmentLength(int b) const;
+    void sortAnchors();
+    void updateAnchor(int t, float dt, const AnchorRing& ring, const Core& core);
+    void integrateChainScalar(int t, const ChainBlock& step);
+    float relaxChainScalar(int t, const ChainBlock& step, const Core& core);
+    float directDistancesScalar(int t, const ChainBlock& step);
+    const TentacleArchetype& archetypeOfSlot(int s) const { return archetypes[blockArchetype[s / LANES]]; }
+    Vector3 point(int s, int i) const;
+    std::size_t at(int s, int i) const {
+        return (static_cast<std::size_t>(s / LANES) * capacity + i) * LANES + (s % LANES);
+    }
+
+    std::vector<TentacleArchetype> archetypes;
+    LodSettings lod;
+    SolverPath solverPath{SolverPath::Simd};
+    SimdIsa isa{DefaultSimdIsa()};
+    ConstraintModel model{ConstraintModel::Pbd};
+    DistanceSolver distanceSolver{DistanceSolver::GaussSeidel};
+    int count{0};
+    int paddedCount{0};
+    // Segment rows reserved per block: the longest archetype's full detail.
+    int capacity{0};
+    // Storage slot of each tentacle, in group order.
+    std::vector<int> slotOf;
+    float attachRadius{0.0f};
+
+    AlignedVector<float> x;
+    AlignedVector<float> y;
+    AlignedVector<float> z;
+    AlignedVector<float> prevX;
+    AlignedVector<float> prevY;
+    AlignedVector<float> prevZ;
+    // Each joint's last displacement, for sleep detection (see
+    // MeasureChainBlock).
+    AlignedVector<float> driftX;
+    AlignedVector<float> driftY;
+    AlignedVector<float> driftZ;
+    // Shape of a sleeping chain without its sway (see HoldChainBlock).
+    AlignedVector<float> heldX;
+    AlignedVector<float> heldY;
+
+    // Positions at the end of the previous step, for render interpolation.
+    AlignedVector<float> tickX;
+    AlignedVector<float> tickY;
+    AlignedVector<float> tickZ;
+
+    // Per-slot state, padded to whole blocks so the kernels can load it
+    // lane-wise.
+    AlignedVector<float> baseAngle;
+    AlignedVector<float> anchorAngle;
+    AlignedVector<float> anchorAngleRead;
+    AlignedVector<float> anchorAV;
+    AlignedVector<float> animationSeed;
+    AlignedVector<float> lastAttachX;
+    AlignedVector<float> lastAttachY;
+    AlignedVector<float> lastAttachZ;
+    AlignedVector<float> coreTangentialVelocity;
+
+    // Per-step kernel inputs produced by updateAnchor.
+    AlignedVector<float> attachX;
+    AlignedVector<float> attachY;
+    AlignedVector<float> attachZ;
+    AlignedVector<float> attachVX;
+    AlignedVector<float> attachVY;
+    AlignedVector<float> anchorCos;
+    AlignedVector<float> anchorSin;
+    AlignedVector<float> coreGain;
+
+    // Slots of the real tentacles sorted by anchorAngleRead, and each slot's
+    // position in that order.
+    std::vector<int> anchorOrder;
+    std::vector<int> anchorRank;
+
+    // One anchor angular-velocity partial sum per block.
+    std::vector<float> blockAV;
+
+    // Archetype of each block and how many of its lanes hold real tentacles.
+    std::vector<int> blockArchetype;
+    std::vector<int> blockLanes;
+
+    // Per-block level of detail. Storage keeps room for the archetype's full
+    // segments so a tier change never reallocates.
+    std::vector<int> blockTier;
+    std::vector<int> blockSegments;
+    std::vector<int> blockDwell;
+    float lodScale{1.0f};
+
+    // Sleep tracking. Energy and error are per tentacle, measured after each
+    // solve; a block sleeps once it has been calm for sleepDelaySteps.
+    AlignedVector<float> kineticEnergy;
+    AlignedVector<float> stretchError;
+    // Running average of stretchError over awake steps.
+    AlignedVector<float> drivenError;
+    std::vector<int> blockCalmSteps;
+    std::vector<unsigned char> blockAsleep;
+    // Wave phase at which each sleeping block's held shape was taken.
+    std::vector<float> blockHeldPhase;
+
+    // Passes each block ran this step and the residual it stopped at.
+    std::vector<int> blockPasses;
+    std::vector<float> blockResidual;
+    SolverStats solverStats;
+};
@@ -0,0 +1,63 @@
+// Baseline build of the chain and particle kernels (F32x1 and, on x86, SSE2)
+// and the run-time choice between builds. The wider builds live in
+// tentacle_kernels_avx2.cpp and tentacle_kernels_avx512.cpp, which CMake
+// compiles with their instruction sets enabled.
+
+#include "particle_kernels.hpp"
+#include "tentacle_kernels.hpp"
+
+ChainKernels ChainKernelsScalar() {
+    return MakeChainKernels<F32x1>();
+}
+
+ParticleKernels ParticleKernelsScalar() {
+    return MakeParticleKernels<F32x1>();
+}
+
+#if defined(ABYSSAL_HAVE_SSE2)
+ChainKernels ChainKernelsSse2() {
+    return MakeChainKernels<F32x4>();
+}
+
+ParticleKernels ParticleKernelsSse2() {
+    return MakeParticleKernels<F32x4>();
+}
+#endif
+
+ChainKernels ChainKernelsFor(SimdIsa isa) {
+    switch (isa) {
+#if defined(ABYSSAL_HAVE_SSE2)
+    case SimdIsa::Sse2:
+        return ChainKernelsSse2();
+#endif
+#if defined(ABYSSAL_BUILD_AVX2)
+    case SimdIsa::Avx2:
+        return ChainKernelsAvx2();
+#endif
+#if defined(ABYSSAL_BUILD_AVX512)
+    case SimdIsa::Avx512:
+        return ChainKernelsAvx512();
+#endif
+    default:
+        return ChainKernelsScalar();
+    }
+}
+
+ParticleKernels ParticleKernelsFor(SimdIsa isa) {
+    switch (isa) {
+#if defined(ABYSSAL_HAVE_SSE2)
+    case SimdIsa::Sse2:
+        return ParticleKernelsSse2();
+#endif
+#if defined(ABYSSAL_BUILD_AVX2)
+    case SimdIsa::Avx2:
+        return ParticleKernelsAvx2();
+#endif
+#if defined(ABYSSAL_BUILD_AVX512)
+    case SimdIsa::Avx512:
+        return ParticleKernelsAvx512();
+#endif
+    default:
+        return ParticleKernelsScalar();
+    }
+}
@@ -0,0 +1,829 @@
+#pragma once
+
+// Lane-parallel chain solver. IntegrateChainBlock followed by passes of
+// RelaxChainBlock advances V::Width tentacles of a bank block by one step:
+// segment i of every lane is processed together, so each chain keeps the same
+// Gauss-Seidel order as the scalar reference in TentacleBank. The caller owns
+// the pass loop so it can stop once the chains have converged.
+//
+// The kernels are built once per SimdIsa, each in its own translation unit
+// with that instruction set enabled, and ChainKernelsFor() picks a build at
+// run time.
+
+#include "cpu_features.hpp"
+#include "fast_math.hpp"
+#include "math_util.hpp"
+#include "simd.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+struct ChainBlock {
+    // Coordinate arrays, offset to the first lane handled by this call.
+    // Consecutive segments are laneStride floats apart.
+    float* x;
+    float* y;
+    float* z;
+    float* prevX;
+    float* prevY;
+    float* prevZ;
+    std::size_t laneStride;
+
+    // Per-lane inputs, offset like the coordinate arrays.
+    const float* attachX;
+    const float* attachY;
+    const float* attachZ;
+    const float* attachVX;
+    const float* attachVY;
+    const float* anchorCos;
+    const float* anchorSin;
+    const float* coreGain;
+    const float* animationSeed;
+    // Scratch for the wave target, laneStride floats per segment; written by
+    // IntegrateChainBlock and read by every pass.
+    float* curvature;
+    // XPBD multipliers of the distance and bend constraints, laid out like
+    // curvature; zeroed by IntegrateChainBlock and accumulated by every pass.
+    float* distanceLambda;
+    float* bendLambda;
+    // Each joint's displacement over the last step less the chain's turn
+    // about the core, laid out like the coordinates; read and rewritten by
+    // MeasureChainBlock.
+    float* driftX;
+    float* driftY;
+    float* driftZ;
+    // A sleeping chain's shape without its wave sway, laid out like the
+    // coordinates; turned and re-swayed by HoldChainBlock.
+    float* heldX;
+    float* heldY;
+
+    int segments;
+    // Solve with XPBD, using distanceAlpha and bendAlpha (compliance / dt^2),
+    // instead of the fixed PBD gains.
+    bool xpbd;
+    // Solve all distance constraints of a chain at once (DirectDistances)
+    // instead of one Gauss-Seidel sweep per pass.
+    bool direct;
+    float distanceAlpha;
+    float bendAlpha;
+    float damp;
+    float keep;
+    float segmentLength;
+    float bendStiffness;
+    float zBias;
+    float waveAmp;
+    float wavePhase;
+    float wavePhaseOffset;
+    // wavePhase when the block fell asleep, where its held shape has no sway.
+    float heldPhase;
+    float minRadius;
+    float coreX;
+    float coreY;
+    float coreZ;
+};
+
+// Inputs and outputs of ProjectChainBlock, offset like ChainBlock.
+struct ProjectionBlock {
+    // Joints at the end of this step and of the previous one; the chain is
+    // drawn alpha of the way between them.
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* fromX;
+    const float* fromY;
+    const float* fromZ;
+    std::size_t laneStride;
+    int segments;
+    float alpha;
+    float originX;
+    float originY;
+    float originZ;
+    // Depth over which segments fade out behind the core.
+    float fadeDepth;
+
+    // Per joint, laneStride floats apart: screen position, depth, stroke
+    // width and depth fade.
+    float* screenX;
+    float* screenY;
+    float* depth;
+    float* width;
+    float* depthAlpha;
+};
+
+constexpr int MAX_CHAIN_SEGMENTS = 64;
+// Segments per collision broadphase chunk.
+constexpr int COLLISION_CHUNK = 8;
+constexpr int MAX_COLLISION_CHUNKS = (MAX_CHAIN_SEGMENTS + COLLISION_CHUNK - 2) / COLLISION_CHUNK;
+
+// Fixed gains of the PBD chain model, shared with the scalar reference.
+struct ChainGains {
+    // Share of the first segment's error taken by its child (the root is
+    // pinned).
+    float rootCorrection;
+    // Anchor velocity handed to joints 1 and 2 each step.
+    float attachKick1;
+    float attachKick2;
+    // Wave amplitude along the chain, from root to tip.
+    float waveEnvelopeRoot;
+    float waveEnvelopeTip;
+    // Share of an orb push on a segment given to its inner joint.
+    float innerPush;
+    // Largest multiplier update of the direct distance solve per pass, in
+    // rest lengths (see DirectDistances).
+    float directMaxStep;
+    // A joint within this many rest lengths of the collision radius is held
+    // by the orb, and the segment ending at it is left out of the residual.
+    float orbHold;
+    // Bend, in radians per unit of wave target (curvature / segmentLength),
+    // that a held chain's sway puts at each joint; matches the sway of a
+    // solved chain in the idle wave.
+    float heldSway;
+};
+
+inline constexpr ChainGains CHAIN_GAINS{0.6f, 0.35f, 0.22f, 0.6f, 1.25f, 0.2f, 1.0f, 0.25f, 0.027f};
+
+// One build's kernels. Each runs over all laneStride lanes of a block,
+// V::Width at a time.
+struct ChainKernels {
+    void (*integrate)(const ChainBlock& b);
+    // Writes each lane's residual (see RelaxChainBlock).
+    void (*relax)(const ChainBlock& b, float* residual);
+    void (*measure)(const ChainBlock& b, const float* turnCos, const float* turnSin, float* energy, float* error);
+    void (*hold)(const ChainBlock& b, const float* turnCos, const float* turnSin);
+    void (*project)(const ProjectionBlock& p);
+};
+
+// Kernels of the isa build. isa must be supported (IsSimdIsaSupported).
+ChainKernels ChainKernelsFor(SimdIsa isa);
+
+// The builds behind ChainKernelsFor, one translation unit each.
+ChainKernels ChainKernelsScalar();
+ChainKernels ChainKernelsSse2();
+ChainKernels ChainKernelsAvx2();
+ChainKernels ChainKernelsAvx512();
+
+inline namespace ABYSSAL_ISA_NAMESPACE {
+// Running mean of |stretch| over a chain's segments, skipping those whose
+// outer joint the orb holds: collision keeps those stretched however many
+// passes run, while the rest converge.
+template <class V>
+struct ChainResidual {
+    V sum;
+    V count;
+    V cx, cy, cz;
+    V hold2;
+
+    explicit ChainResidual(const ChainBlock& b)
+        : sum(V::Set(0.0f)), count(V::Set(0.0f)), cx(V::Set(b.coreX)), cy(V::Set(b.coreY)), cz(V::Set(b.coreZ)) {
+        const float hold = b.minRadius + CHAIN_GAINS.orbHold * b.segmentLength;
+        hold2 = V::Set(hold * hold);
+    }
+
+    void Add(V stretch, V px, V py, V pz) {
+        const V zero = V::Set(0.0f);
+        const V hx = px - cx, hy = py - cy, hz = pz - cz;
+        const auto held = hx * hx + hy * hy + hz * hz < hold2;
+        sum = sum + Select(held, zero, Max(stretch, zero - stretch));
+        count = count + Select(held, zero, V::Set(1.0f));
+    }
+
+    V Mean() const { return sum / Max(count, V::Set(1.0f)); }
+};
+
+// Pins the roots, applies Verlet integration and the anchor kick, and
+// evaluates the wave target, which does not change between passes.
+template <class V>
+void IntegrateChainBlock(const ChainBlock& b) {
+    const int n = b.segments;
+    if (n <= 0 || n > MAX_CHAIN_SEGMENTS) return;
+    const std::size_t s = b.laneStride;
+
+    auto ld = [](const float* p) { return V::Load(p); };
+
+    const V ax = ld(b.attachX);
+    const V ay = ld(b.attachY);
+    const V az = ld(b.attachZ);
+    ax.Store(b.x);
+    ay.Store(b.y);
+    az.Store(b.z);
+    ax.Store(b.prevX);
+    ay.Store(b.prevY);
+    az.Store(b.prevZ);
+
+    const V damp = V::Set(b.damp);
+    const V keep = V::Set(b.keep);
+    for (int i = 1; i < n; ++i) {
+        const std::size_t k = i * s;
+        V px = ld(b.x + k), py = ld(b.y + k), pz = ld(b.z + k);
+        V vx = (px - ld(b.prevX + k)) * damp;
+        V vy = (py - ld(b.prevY + k)) * damp;
+        V vz = (pz - ld(b.prevZ + k)) * damp;
+        px.Store(b.prevX + k);
+        py.Store(b.prevY + k);
+        pz.Store(b.prevZ + k);
+        (px + vx * keep).Store(b.x + k);
+        (py + vy * keep).Store(b.y + k);
+        (pz + vz * keep).Store(b.z + k);
+    }
+
+    if (n > 2) {
+        const V vax = ld(b.attachVX);
+        const V vay = ld(b.attachVY);
+        const V g1 = V::Set(CHAIN_GAINS.attachKick1);
+        const V g2 = V::Set(CHAIN_GAINS.attachKick2);
+        (ld(b.x + s) + vax * g1).Store(b.x + s);
+        (ld(b.y + s) + vay * g1).Store(b.y + s);
+        (ld(b.x + 2 * s) + vax * g2).Store(b.x + 2 * s);
+        (ld(b.y + 2 * s) + vay * g2).Store(b.y + 2 * s);
+    }
+
+    // The wave phase falls by wavePhaseOffset per joint, so one SinCos at
+    // joint 1 and a rotation per joint after it cover the whole chain.
+    const V gain = ld(b.coreGain);
+    float stepSin, stepCos;
+    SinCos(0.0f - b.wavePhaseOffset, stepSin, stepCos);
+    Phasor<V> wave = Phasor<V>::Start(V::Set(b.wavePhase - b.wavePhaseOffset) + ld(b.animationSeed));
+    for (int i = 1; i + 1 < n; ++i) {
+        const float idxT = static_cast<float>(i) / static_cast<float>(n - 1);
+        const float env = CHAIN_GAINS.waveEnvelopeRoot + (CHAIN_GAINS.waveEnvelopeTip - CHAIN_GAINS.waveEnvelopeRoot) * idxT;
+        (V::Set(b.waveAmp * env) * gain * wave.sin * V::Set(b.segmentLength)).Store(b.curvature + i * s);
+        wave.Advance(V::Set(stepSin), V::Set(stepCos));
+    }
+
+    if (b.xpbd) {
+        const V zero = V::Set(0.0f);
+        for (int i = 0; i < n; ++i) {
+            zero.Store(b.distanceLambda + i * s);
+            zero.Store(b.bendLambda + i * s);
+        }
+    }
+}
+
+// Direct distance solve. Linearised about the current joints, the distance
+// constraints of a chain anchored at a fixed root form a tridiagonal system in
+// the multiplier updates, (J W J^T + alpha) dl = -C - alpha * lambda: each
+// constraint couples only to its neighbours through the joint they share.
+// The Thomas algorithm solves it exactly in one forward and one backward
+// sweep, and the backward sweep applies the joint corrections as it goes.
+// The linearisation only holds for small violations: a badly stretched or
+// folded chain makes the system nearly singular and the exact step
+// overshoots, so every update is clamped to CHAIN_GAINS.directMaxStep rest
+// lengths and later passes finish the job.
+// Returns per lane the mean residual before the solve (see ChainResidual).
+template <class V>
+V DirectDistances(const ChainBlock& b) {
+    using Mask = typename V::Mask;
+    const int n = b.segments;
+    const std::size_t s = b.laneStride;
+    auto ld = [](const float* p) { return V::Load(p); };
+    const V zero = V::Set(0.0f);
+    const V one = V::Set(1.0f);
+    const V eps2 = V::Set(1e-8f);
+    const V segLen = V::Set(b.segmentLength);
+    const V alpha = V::Set(b.xpbd ? b.distanceAlpha : 0.0f);
+    const V maxStep = V::Set(CHAIN_GAINS.directMaxStep * b.segmentLength);
+
+    // Constraint i joins joints i-1 and i; normals point towards the tip.
+    V nx[MAX_CHAIN_SEGMENTS], ny[MAX_CHAIN_SEGMENTS], nz[MAX_CHAIN_SEGMENTS];
+    V upper[MAX_CHAIN_SEGMENTS], rhs[MAX_CHAIN_SEGMENTS];
+    ChainResidual<V> residual(b);
+    for (int i = 1; i < n; ++i) {
+        const std::size_t ka = (i - 1) * s, kb = i * s;
+        const V pbx = ld(b.x + kb), pby = ld(b.y + kb), pbz = ld(b.z + kb);
+        V dx = pbx - ld(b.x + ka), dy = pby - ld(b.y + ka), dz = pbz - ld(b.z + ka);
+        const V dist2 = dx * dx + dy * dy + dz * dz;
+        const Mask tiny = dist2 < eps2;
+        const V inv = Select(tiny, one, Rsqrt(Select(tiny, one, dist2)));
+        const V dist = Select(tiny, one, dist2 * inv);
+        V stretch = dist - segLen;
+        residual.Add(stretch, pbx, pby, pbz);
+        nx[i] = dx * inv;
+        ny[i] = dy * inv;
+        nz[i] = dz * inv;
+        rhs[i] = zero - stretch;
+        if (b.xpbd) rhs[i] = rhs[i] - alpha * ld(b.distanceLambda + kb);
+    }
+
+    // Forward sweep. The root has no inverse mass, so the first diagonal
+    // is 1 and every other one 2; the coupling through joint i is
+    // -n_i . n_(i+1).
+    for (int i = 1; i < n; ++i) {
+        V diag = V::Set(i == 1 ? 1.0f : 2.0f) + alpha;
+        if (i > 1) {
+            const V lower = zero - (nx[i - 1] * nx[i] + ny[i - 1] * ny[i] + nz[i - 1] * nz[i]);
+            diag = diag - lower * upper[i - 1];
+            rhs[i] = rhs[i] - lower * rhs[i - 1];
+        }
+        const V inv = one / diag;
+        upper[i] = i + 1 < n ? (zero - (nx[i] * nx[i + 1] + ny[i] * ny[i + 1] + nz[i] * nz[i + 1])) * inv : zero;
+        rhs[i] = rhs[i] * inv;
+    }
+
+    // Back substitution. Joint i moves along n_i by its own constraint's
+    // update and against n_(i+1) by the next one's.
+    V next = zero;
+    for (int i = n - 1; i >= 1; --i) {
+        const std::size_t k = i * s;
+        const V dl = Min(Max(rhs[i] - upper[i] * next, zero - maxStep), maxStep);
+        if (b.xpbd) (ld(b.distanceLambda + k) + dl).Store(b.distanceLambda + k);
+        V mx = nx[i] * dl, my = ny[i] * dl, mz = nz[i] * dl;
+        if (i + 1 < n) {
+            mx = mx - nx[i + 1] * next;
+            my = my - ny[i + 1] * next;
+            mz = mz - nz[i + 1] * next;
+        }
+        (ld(b.x + k) + mx).Store(b.x + k);
+        (ld(b.y + k) + my).Store(b.y + k);
+        (ld(b.z + k) + mz).Store(b.z + k);
+        next = dl;
+    }
+    return residual.Mean();
+}
+
+// One constraint pass: distances, bend and wave, then orb collision. Returns
+// per lane the mean distance-constraint residual (|length - rest|, in px)
+// met during the sweep, before each constraint was projected, over the
+// segments the orb does not hold (see ChainResidual).
+template <class V>
+V RelaxChainBlock(const ChainBlock& b) {
+    using Mask = typename V::Mask;
+    const int n = b.segments;
+    const V zero = V::Set(0.0f);
+    if (n <= 1 || n > MAX_CHAIN_SEGMENTS) return zero;
+    const std::size_t s = b.laneStride;
+
+    auto ld = [](const float* p) { return V::Load(p); };
+
+    const V ax = ld(b.attachX);
+    const V ay = ld(b.attachY);
+    const V az = ld(b.attachZ);
+    const V one = V::Set(1.0f);
+    const V half = V::Set(0.5f);
+    const V eps = V::Set(1e-4f);
+    const V eps2 = V::Set(1e-8f);
+    const V segLen = V::Set(b.segmentLength);
+    const V bend = V::Set(b.bendStiffness);
+    const V zLift = V::Set(b.zBias * b.segmentLength);
+    const V minR = V::Set(b.minRadius);
+    const V cx = V::Set(b.coreX), cy = V::Set(b.coreY), cz = V::Set(b.coreZ);
+    const V fallbackX = ld(b.anchorCos);
+    const V fallbackY = ld(b.anchorSin);
+    const V distAlpha = V::Set(b.distanceAlpha);
+    const V bendAlpha = V::Set(b.bendAlpha);
+
+    V residual = zero;
+    // distance constraints
+    if (b.direct) {
+        residual = DirectDistances<V>(b);
+    } else {
+        ChainResidual<V> sweep(b);
+        for (int i = 1; i < n; ++i) {
+            const std::size_t ka = (i - 1) * s, kb = i * s;
+            V pax = ld(b.x + ka), pay = ld(b.y + ka), paz = ld(b.z + ka);
+            V pbx = ld(b.x + kb), pby = ld(b.y + kb), pbz = ld(b.z + kb);
+            V dx = pbx - pax, dy = pby - pay, dz = pbz - paz;
+            // A segment shorter than 1e-4 is treated as unit length, which
+            // also keeps Rsqrt away from zero.
+            const V dist2 = dx * dx + dy * dy + dz * dz;
+            const Mask tiny = dist2 < eps2;
+            const V inv = Select(tiny, one, Rsqrt(Select(tiny, one, dist2)));
+            const V dist = Select(tiny, one, dist2 * inv);
+            V stretch = dist - segLen;
+            sweep.Add(stretch, pbx, pby, pbz);
+            if (b.xpbd) {
+                // The root is fixed, so the first segment moves only its child.
+                const V lambda = ld(b.distanceLambda + kb);
+                const V weight = V::Set(i == 1 ? 1.0f : 2.0f);
+                const V dl = (zero - stretch - distAlpha * lambda) / (weight + distAlpha);
+                (lambda + dl).Store(b.distanceLambda + kb);
+                const V scale = dl * inv;
+                V corrX = dx * scale, corrY = dy * scale, corrZ = dz * scale;
+                (pbx + corrX).Store(b.x + kb);
+                (pby + corrY).Store(b.y + kb);
+                (pbz + corrZ).Store(b.z + kb);
+                if (i > 1) {
+                    (pax - corrX).Store(b.x + ka);
+                    (pay - corrY).Store(b.y + ka);
+                    (paz - corrZ).Store(b.z + ka);
+                }
+                continue;
+            }
+            V diff = stretch * inv;
+            if (i == 1) {
+                const V g = V::Set(CHAIN_GAINS.rootCorrection);
+                (pbx - dx * diff * g).Store(b.x + kb);
+                (pby - dy * diff * g).Store(b.y + kb);
+                (pbz - dz * diff * g).Store(b.z + kb);
+            } else {
+                V corrX = dx * diff * half, corrY = dy * diff * half, corrZ = dz * diff * half;
+                (pax + corrX).Store(b.x + ka);
+                (pay + corrY).Store(b.y + ka);
+                (paz + corrZ).Store(b.z + ka);
+                (pbx - corrX).Store(b.x + kb);
+                (pby - corrY).Store(b.y + kb);
+                (pbz - corrZ).Store(b.z + kb);
+            }
+        }
+        residual = sweep.Mean();
+    }
+    ax.Store(b.x);
+    ay.Store(b.y);
+    az.Store(b.z);
+
+    // Collision broadphase. Chunk c covers segments cC+1..(c+1)C and their
+    // joints. A segment can only reach the orb if one of its ends is within
+    // half its length of minRadius, so a chunk whose nearest joint clears
+    // minRadius by half its longest segment cannot be hit. The bend pass
+    // below leaves every joint final before collision, so it collects each
+    // chunk's nearest joint and longest segment as it goes. Collision only
+    // pushes joints away from the core, so the bound holds through both
+    // collision loops; only a push on the joint shared with the previous
+    // chunk can stretch a segment, and that chunk is then visited anyway.
+    const int chunks = (n - 1 + COLLISION_CHUNK - 1) / COLLISION_CHUNK;
+    V minDist2[MAX_COLLISION_CHUNKS];
+    V maxLen2[MAX_COLLISION_CHUNKS];
+    {
+        const V rx = ax - cx, ry = ay - cy, rz = az - cz;
+        minDist2[0] = rx * rx + ry * ry + rz * rz;
+        maxLen2[0] = zero;
+        for (int c = 1; c < chunks; ++c) {
+            minDist2[c] = V::Set(3.0e38f);
+            maxLen2[c] = zero;
+        }
+    }
+    const auto bound = [&](int j, V px, V py, V pz, V qx, V qy, V qz) {
+        // Joint j and the segment ending at it.
+        const V dx = px - cx, dy = py - cy, dz = pz - cz;
+        const V dist2 = dx * dx + dy * dy + dz * dz;
+        const V lx = px - qx, ly = py - qy, lz = pz - qz;
+        const int c = (j - 1) / COLLISION_CHUNK;
+        minDist2[c] = Min(minDist2[c], dist2);
+        maxLen2[c] = Max(maxLen2[c], lx * lx + ly * ly + lz * lz);
+        if (j % COLLISION_CHUNK == 0 && c + 1 < chunks) minDist2[c + 1] = Min(minDist2[c + 1], dist2);
+    };
+
+    // bend stiffness & wave
+    for (int i = 1; i + 1 < n; ++i) {
+        const std::size_t k0 = (i - 1) * s, k1 = i * s, k2 = (i + 1) * s;
+        V p0x = ld(b.x + k0), p0y = ld(b.y + k0), p0z = ld(b.z + k0);
+        V p1x = ld(b.x + k1), p1y = ld(b.y + k1), p1z = ld(b.z + k1);
+        V p2x = ld(b.x + k2), p2y = ld(b.y + k2), p2z = ld(b.z + k2);
+
+        V midX = (p0x + p2x) * half, midY = (p0y + p2y) * half, midZ = (p0z + p2z) * half;
+        // Chord direction, or +y when its ends coincide.
+        V tx = p2x - p0x, ty = p2y - p0y, tz = p2z - p0z;
+        V tlen2 = tx * tx + ty * ty + tz * tz;
+        Mask degenerate = tlen2 < eps2;
+        V tinv = Rsqrt(Select(degenerate, one, tlen2));
+        tx = Select(degenerate, zero, tx * tinv);
+        ty = Select(degenerate, one, ty * tinv);
+        tz = Select(degenerate, zero, tz * tinv);
+
+        V rx = p1x - cx, ry = p1y - cy, rz = p1z - cz;
+        V dotTR = rx * tx + ry * ty + rz * tz;
+        V nx = rx - tx * dotTR, ny = ry - ty * dotTR, nz = rz - tz * dotTR;
+        nz = nz + zLift;
+        V nlen2 = nx * nx + ny * ny + nz * nz;
+        Mask flat = nlen2 < eps2;
+        V ninv = Rsqrt(Select(flat, one, nlen2));
+        nx = Select(flat, zero, nx * ninv);
+        ny = Select(flat, zero, ny * ninv);
+        nz = Select(flat, one, nz * ninv);
+
+        V c = ld(b.curvature + k1);
+        V targetX = midX + nx * c, targetY = midY + ny * c, targetZ = midZ + nz * c;
+        if (b.xpbd) {
+            // C = |p1 - target|, pulling p1 alone towards the target.
+            V ex = p1x - targetX, ey = p1y - targetY, ez = p1z - targetZ;
+            V err = Sqrt(ex * ex + ey * ey + ez * ez);
+            Mask moved = eps < err;
+            const V lambda = ld(b.bendLambda + k1);
+            V dl = Select(moved, (zero - err - bendAlpha * lambda) / (one + bendAlpha), zero);
+            (lambda + dl).Store(b.bendLambda + k1);
+            V scale = dl / Select(moved, err, one);
+            p1x = p1x + ex * scale;
+            p1y = p1y + ey * scale;
+            p1z = p1z + ez * scale;
+        } else {
+            p1x = p1x + (targetX - p1x) * bend;
+            p1y = p1y + (targetY - p1y) * bend;
+            p1z = p1z + (targetZ - p1z) * bend;
+        }
+        p1x.Store(b.x + k1);
+        p1y.Store(b.y + k1);
+        p1z.Store(b.z + k1);
+        bound(i, p1x, p1y, p1z, p0x, p0y, p0z);
+    }
+    {
+        const std::size_t ka = (n - 2) * s, kb = (n - 1) * s;
+        bound(n - 1, ld(b.x + kb), ld(b.y + kb), ld(b.z + kb), ld(b.x + ka), ld(b.y + ka), ld(b.z + ka));
+    }
+    bool nearOrb[MAX_COLLISION_CHUNKS];
+    const V slack = V::Set(1.001f);
+    for (int c = 0; c < chunks; ++c) {
+        const V reach = minR + Sqrt(maxLen2[c]) * half;
+        nearOrb[c] = Any(minDist2[c] < reach * reach * slack);
+    }
+
+    // collision with orb
+    for (int c = 0; c < chunks; ++c) {
+        if (!nearOrb[c]) continue;
+        const int first = c * COLLISION_CHUNK;
+        const int last = first + COLLISION_CHUNK < n - 1 ? first + COLLISION_CHUNK : n - 1;
+        for (int j = first + 1; j <= last; ++j) {
+            const std::size_t k = j * s;
+            V px = ld(b.x + k), py = ld(b.y + k), pz = ld(b.z + k);
+            V dx = px - cx, dy = py - cy, dz = pz - cz;
+            V dist = Sqrt(dx * dx + dy * dy + dz * dz);
+            Mask inside = dist < minR;
+            if (!Any(inside)) continue;
+            Mask degenerate = dist < eps;
+            dx = Select(degenerate, fallbackX, dx);
+            dy = Select(degenerate, fallbackY, dy);
+            dz = Select(degenerate, zero, dz);
+            dist = Select(degenerate, one, dist);
+            V inv = one / dist;
+            Select(inside, cx + dx * inv * minR, px).Store(b.x + k);
+            Select(inside, cy + dy * inv * minR, py).Store(b.y + k);
+            Select(inside, cz + dz * inv * minR, pz).Store(b.z + k);
+        }
+    }
+
+    // segment-line collision vs orb
+    bool pushedShared = false;
+    for (int c = 0; c < chunks; ++c) {
+        if (!nearOrb[c] && !pushedShared) continue;
+        pushedShared = false;
+        const int first = c * COLLISION_CHUNK;
+        const int last = first + COLLISION_CHUNK < n - 1 ? first + COLLISION_CHUNK : n - 1;
+        for (int j = first + 1; j <= last; ++j) {
+            const std::size_t ka = (j - 1) * s, kb = j * s;
+            V pax = ld(b.x + ka), pay = ld(b.y + ka), paz = ld(b.z + ka);
+            V pbx = ld(b.x + kb), pby = ld(b.y + kb), pbz = ld(b.z + kb);
+            V vx = pbx - pax, vy = pby - pay, vz = pbz - paz;
+            V denom = vx * vx + vy * vy + vz * vz;
+            Mask valid = denom >= V::Set(1e-5f);
+            if (!Any(valid)) continue;
+            V wx = cx - pax, wy = cy - pay, wz = cz - paz;
+            V t = (vx * wx + vy * wy + vz * wz) / Select(valid, denom, one);
+            t = Min(Max(t, zero), one);
+            V dx = pax + vx * t - cx, dy = pay + vy * t - cy, dz = paz + vz * t - cz;
+            V dist = Sqrt(dx * dx + dy * dy + dz * dz);
+            Mask hit = valid & (dist < minR);
+            if (!Any(hit)) continue;
+            pushedShared = j == last;
+            Mask degenerate = dist < eps;
+            dx = Select(degenerate, fallbackX, dx);
+            dy = Select(degenerate, fallbackY, dy);
+            dz = Select(degenerate, zero, dz);
+            dist = Select(degenerate, one, dist);
+            V inv = one / dist;
+            V push = Select(hit, minR - dist, zero);
+            V nx = dx * inv, ny = dy * inv, nz = dz * inv;
+            Select(hit, pbx + nx * push, pbx).Store(b.x + kb);
+            Select(hit, pby + ny * push, pby).Store(b.y + kb);
+            Select(hit, pbz + nz * push, pbz).Store(b.z + kb);
+            if (j > 1) {
+                const V g = V::Set(CHAIN_GAINS.innerPush);
+                Select(hit, pax + nx * push * g, pax).Store(b.x + ka);
+                Select(hit, pay + ny * push * g, pay).Store(b.y + ka);
+                Select(hit, paz + nz * push * g, paz).Store(b.z + ka);
+            }
+        }
+    }
+    ax.Store(b.x);
+    ay.Store(b.y);
+    az.Store(b.z);
+    return residual;
+}
+
+// Per-lane state after a step, for sleep detection. energy is the mean
+// squared change in joint velocity from the last step to this one, with the
+// rigid turn of the chain about the core (turnCos/turnSin per lane) taken
+// out of both: a chain carried round by a spinning ring, or swaying in a
+// steady wave, barely accelerates, while a push or a yank does. error is the
+// mean deviation of a segment from its rest length, relative to that length;
+// the root segments always carry some, so the largest would never settle.
+template <class V>
+void MeasureChainBlock(const ChainBlock& b, const float* turnCos, const float* turnSin, float* energy, float* error) {
+    const int n = b.segments;
+    const std::size_t s = b.laneStride;
+    auto ld = [](const float* p) { return V::Load(p); };
+    const V zero = V::Set(0.0f);
+    const V cx = V::Set(b.coreX), cy = V::Set(b.coreY);
+    const V c = ld(turnCos), sn = ld(turnSin);
+    const V segLen = V::Set(b.segmentLength);
+    V sum = zero;
+    V stretchSum = zero;
+    for (int i = 1; i < n; ++i) {
+        const std::size_t ka = (i - 1) * s, kb = i * s;
+        V px = ld(b.x + kb), py = ld(b.y + kb), pz = ld(b.z + kb);
+        V qx = ld(b.prevX + kb) - cx, qy = ld(b.prevY + kb) - cy;
+        V vx = px - (cx + qx * c - qy * sn);
+        V vy = py - (cy + qx * sn + qy * c);
+        V vz = pz - ld(b.prevZ + kb);
+        // Last step's drift, turned with the chain.
+        V lx = ld(b.driftX + kb), ly = ld(b.driftY + kb);
+        V ax = vx - (lx * c - ly * sn);
+        V ay = vy - (lx * sn + ly * c);
+        V az = vz - ld(b.driftZ + kb);
+        sum = sum + ax * ax + ay * ay + az * az;
+        vx.Store(b.driftX + kb);
+        vy.Store(b.driftY + kb);
+        vz.Store(b.driftZ + kb);
+        V dx = px - ld(b.x + ka), dy = py - ld(b.y + ka), dz = pz - ld(b.z + ka);
+        V stretch = Sqrt(dx * dx + dy * dy + dz * dz) - segLen;
+        stretchSum = stretchSum + Max(stretch, zero - stretch);
+    }
+    const V joints = V::Set(static_cast<float>(n > 1 ? n - 1 : 1));
+    (sum / joints).Store(energy);
+    (stretchSum / (joints * segLen)).Store(error);
+}
+
+// Carries a sleeping block's chains round the core instead of solving them.
+// The held shape turns about the core with its lane's anchor
+// (turnCos/turnSin) and its root is pinned to the anchor, which keeps every
+// segment's length and its clearance from the orb. The wave then sways it
+// analytically: each joint bends by the change of its wave target since the
+// block fell asleep (heldPhase), and the bends are chained from root to tip,
+// so segment lengths still hold. The positions left become the previous
+// ones, so a chain that wakes keeps moving as it did, and the drift is
+// cleared.
+template <class V>
+void HoldChainBlock(const ChainBlock& b, const float* turnCos, const float* turnSin) {
+    const int n = b.segments;
+    if (n <= 0 || n > MAX_CHAIN_SEGMENTS) return;
+    const std::size_t s = b.laneStride;
+    auto ld = [](const float* p) { return V::Load(p); };
+    const V zero = V::Set(0.0f);
+    const V cx = V::Set(b.coreX), cy = V::Set(b.coreY);
+    const V c = ld(turnCos), sn = ld(turnSin);
+    for (int i = 1; i < n; ++i) {
+        const std::size_t k = i * s;
+        const V qx = ld(b.heldX + k) - cx, qy = ld(b.heldY + k) - cy;
+        (cx + qx * c - qy * sn).Store(b.heldX + k);
+        (cy + qx * sn + qy * c).Store(b.heldY + k);
+    }
+    ld(b.attachX).Store(b.heldX);
+    ld(b.attachY).Store(b.heldY);
+
+    // Same joint phases as IntegrateChainBlock, now and at heldPhase.
+    const V gain = ld(b.coreGain) * V::Set(b.waveAmp * CHAIN_GAINS.heldSway);
+    float stepSin, stepCos;
+    SinCos(0.0f - b.wavePhaseOffset, stepSin, stepCos);
+    const V seed = ld(b.animationSeed);
+    Phasor<V> now = Phasor<V>::Start(V::Set(b.wavePhase - b.wavePhaseOffset) + seed);
+    Phasor<V> then = Phasor<V>::Start(V::Set(b.heldPhase - b.wavePhaseOffset) + seed);
+    // Sway turn of the segment after the current joint.
+    V bendCos = V::Set(1.0f), bendSin = zero;
+    V px = ld(b.attachX), py = ld(b.attachY);
+    V hx = px, hy = py;
+    for (int i = 0; i < n; ++i) {
+        const std::size_t k = i * s;
+        if (i > 0) {
+            const V nx = ld(b.heldX + k), ny = ld(b.heldY + k);
+            const V dx = nx - hx, dy = ny - hy;
+            hx = nx;
+            hy = ny;
+            px = px + dx * bendCos - dy * bendSin;
+            py = py + dx * bendSin + dy * bendCos;
+        }
+        ld(b.x + k).Store(b.prevX + k);
+        ld(b.y + k).Store(b.prevY + k);
+        ld(b.z + k).Store(b.prevZ + k);
+        px.Store(b.x + k);
+        py.Store(b.y + k);
+        zero.Store(b.driftX + k);
+        zero.Store(b.driftY + k);
+        zero.Store(b.driftZ + k);
+        if (i == 0 || i + 1 >= n) continue;
+        const float idxT = static_cast<float>(i) / static_cast<float>(n - 1);
+        const float env = CHAIN_GAINS.waveEnvelopeRoot + (CHAIN_GAINS.waveEnvelopeTip - CHAIN_GAINS.waveEnvelopeRoot) * idxT;
+        V turnS, turnC;
+        SinCos(V::Set(env) * gain * (now.sin - then.sin), turnS, turnC);
+        const V nextCos = bendCos * turnC - bendSin * turnS;
+        bendSin = bendCos * turnS + bendSin * turnC;
+        bendCos = nextCos;
+        now.Advance(V::Set(stepSin), V::Set(stepCos));
+        then.Advance(V::Set(stepSin), V::Set(stepCos));
+    }
+}
+
+// Projects a block's chains for drawing: blends each joint between the two
+// steps, projects it like ProjectPoint, and derives its width (tapering to
+// the tip and growing with perspective) and depth fade.
+template <class V>
+void ProjectChainBlock(const ProjectionBlock& p) {
+    const int n = p.segments;
+    const std::size_t s = p.laneStride;
+    auto ld = [](const float* ptr) { return V::Load(ptr); };
+    const V alpha = V::Set(p.alpha);
+    const V ox = V::Set(p.originX), oy = V::Set(p.originY), oz = V::Set(p.originZ);
+    const V cameraZ = V::Set(CAMERA_Z);
+    const V cameraF = V::Set(CAMERA_F);
+    const V minDenom = V::Set(0.001f);
+    const V perspective = V::Set(0.02f);
+    const V minGrow = V::Set(0.6f), maxGrow = V::Set(2.0f);
+    const V fadeBase = V::Set(0.7f), fadeDepth = V::Set(p.fadeDepth);
+    const V minFade = V::Set(0.2f), maxFade = V::Set(1.0f);
+    const float baseWidth = 6.4f;
+    const float tipWidth = 3.2f;
+
+    for (int i = 0; i < n; ++i) {
+        const std::size_t k = i * s;
+        const V fx = ld(p.fromX + k), fy = ld(p.fromY + k), fz = ld(p.fromZ + k);
+        const V px = fx + (ld(p.x + k) - fx) * alpha;
+        const V py = fy + (ld(p.y + k) - fy) * alpha;
+        const V pz = fz + (ld(p.z + k) - fz) * alpha;
+        const V scale = cameraF / Max(minDenom, cameraZ - (pz - oz));
+        const float along = n > 1 ? static_cast<float>(i) / static_cast<float>(n - 1) : 0.0f;
+        const V taper = V::Set(baseWidth + (tipWidth - baseWidth) * along);
+        (ox + (px - ox) * scale).Store(p.screenX + k);
+        (oy + (py - oy) * scale).Store(p.screenY + k);
+        pz.Store(p.depth + k);
+        (taper * Min(maxGrow, Max(minGrow, scale * perspective))).Store(p.width + k);
+        Min(maxFade, Max(minFade, fadeBase + pz / fadeDepth)).Store(p.depthAlpha + k);
+    }
+}
+
+// b with every lane pointer moved lane lanes along.
+inline ChainBlock ShiftLanes(const ChainBlock& b, int lane) {
+    ChainBlock shifted = b;
+    shifted.x += lane;
+    shifted.y += lane;
+    shifted.z += lane;
+    shifted.prevX += lane;
+    shifted.prevY += lane;
+    shifted.prevZ += lane;
+    shifted.attachX += lane;
+    shifted.attachY += lane;
+    shifted.attachZ += lane;
+    shifted.attachVX += lane;
+    shifted.attachVY += lane;
+    shifted.anchorCos += lane;
+    shifted.anchorSin += lane;
+    shifted.coreGain += lane;
+    shifted.animationSeed += lane;
+    shifted.curvature += lane;
+    shifted.distanceLambda += lane;
+    shifted.bendLambda += lane;
+    shifted.driftX += lane;
+    shifted.driftY += lane;
+    shifted.driftZ += lane;
+    shifted.heldX += lane;
+    shifted.heldY += lane;
+    return shifted;
+}
+
+template <class V>
+void IntegrateLanes(const ChainBlock& b) {
+    for (int lane = 0; lane < static_cast<int>(b.laneStride); lane += V::Width) {
+        IntegrateChainBlock<V>(ShiftLanes(b, lane));
+    }
+}
+
+template <class V>
+void RelaxLanes(const ChainBlock& b, float* residual) {
+    for (int lane = 0; lane < static_cast<int>(b.laneStride); lane += V::Width) {
+        RelaxChainBlock<V>(ShiftLanes(b, lane)).Store(residual + lane);
+    }
+}
+
+template <class V>
+void MeasureLanes(const ChainBlock& b, const float* turnCos, const float* turnSin, float* energy, float* error) {
+    for (int lane = 0; lane < static_cast<int>(b.laneStride); lane += V::Width) {
+        MeasureChainBlock<V>(ShiftLanes(b, lane), turnCos + lane, turnSin + lane, energy + lane, error + lane);
+    }
+}
+
+template <class V>
+void HoldLanes(const ChainBlock& b, const float* turnCos, const float* turnSin) {
+    for (int lane = 0; lane < static_cast<int>(b.laneStride); lane += V::Width) {
+        HoldChainBlock<V>(ShiftLanes(b, lane), turnCos + lane, turnSin + lane);
+    }
+}
+
+template <class V>
+void ProjectLanes(const ProjectionBlock& p) {
+    for (int lane = 0; lane < static_cast<int>(p.laneStride); lane += V::Width) {
+        ProjectionBlock shifted = p;
+        shifted.x += lane;
+        shifted.y += lane;
+        shifted.z += lane;
+        shifted.fromX += lane;
+        shifted.fromY += lane;
+        shifted.fromZ += lane;
+        shifted.screenX += lane;
+        shifted.screenY += lane;
+        shifted.depth += lane;
+        shifted.width += lane;
+        shifted.depthAlpha += lane;
+        ProjectChainBlock<V>(shifted);
+    }
+}
+
+template <class V>
+constexpr ChainKernels MakeChainKernels() {
+    return {&IntegrateLanes<V>, &RelaxLanes<V>, &MeasureLanes<V>, &HoldLanes<V>, &ProjectLanes<V>};
+}
+}
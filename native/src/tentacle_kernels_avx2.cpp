@@ -0,0 +1,14 @@
+// AVX2 build of the chain and particle kernels. CMake compiles this file with
+// AVX2 enabled; ChainKernelsFor and ParticleKernelsFor only call it once
+// CPUID has reported AVX2.
+
+#include "particle_kernels.hpp"
+#include "tentacle_kernels.hpp"
+
+ChainKernels ChainKernelsAvx2() {
+    return MakeChainKernels<F32x8>();
+}
+
+ParticleKernels ParticleKernelsAvx2() {
+    return MakeParticleKernels<F32x8>();
+}
@@ -0,0 +1,15 @@
+// AVX-512 build of the chain and particle kernels: the same 8-lane code as the
+// AVX2 build, compiled with AVX-512F and AVX-512VL for the extra vector
+// registers and mask compares. ChainKernelsFor and ParticleKernelsFor only
+// call it once CPUID has reported both.
+
+#include "particle_kernels.hpp"
+#include "tentacle_kernels.hpp"
+
+ChainKernels ChainKernelsAvx512() {
+    return MakeChainKernels<F32x8>();
+}
+
+ParticleKernels ParticleKernelsAvx512() {
+    return MakeParticleKernels<F32x8>();
+}
@@ -0,0 +1,93 @@
+#include "tentacle_mesh.hpp"
+
+#include <algorithm>
+
+namespace {
+unsigned char Alpha(Color color, float fade) {
+    return static_cast<unsigned char>(std::clamp(static_cast<float>(color.a) * fade, 0.0f, 255.0f));
+}
+}
+
+void TentacleMesh::Build(const ChainDrawBatch& batch, Color body, Color glow) {
+    backRuns.clear();
+    frontRuns.clear();
+    for (int c = 0; c < batch.Chains(); ++c) addRuns(batch, c);
+    // Painter's order, as the core sits between the two lists.
+    std::sort(backRuns.begin(), backRuns.end(), [](const Run& a, const Run& b) { return a.depth < b.depth; });
+    std::sort(frontRuns.begin(), frontRuns.end(), [](const Run& a, const Run& b) { return a.depth > b.depth; });
+
+    strips.Clear();
+    for (const Run& run : backRuns) emitRun(batch, run, body, glow);
+    // The front strips start a fresh chunk so the core can go in between.
+    backChunks = strips.Split();
+    for (const Run& run : frontRuns) emitRun(batch, run, body, glow);
+    strips.Upload();
+}
+
+void TentacleMesh::DrawBack() const {
+    strips.Draw(0, backChunks);
+}
+
+void TentacleMesh::DrawFront() const {
+    strips.Draw(backChunks, strips.Chunks());
+}
+
+void TentacleMesh::addRuns(const ChainDrawBatch& batch, int chain) {
+    const std::span<const JointDraw> joints = batch.Chain(chain);
+    const int n = static_cast<int>(joints.size());
+    int first = 0;
+    float depthSum = 0.0f;
+    for (int i = 1; i < n; ++i) {
+        const float avgZ = (joints[i - 1].depth + joints[i].depth) * 0.5f;
+        depthSum += avgZ;
+        const bool back = avgZ < 0.0f;
+        const bool ends = i == n - 1 || ((joints[i].depth + joints[i + 1].depth) * 0.5f < 0.0f) != back;
+        if (!ends) continue;
+        const Run run{chain, first, i, depthSum / static_cast<float>(i - first)};
+        (back ? backRuns : frontRuns).push_back(run);
+        first = i;
+        depthSum = 0.0f;
+    }
+}
+
+void TentacleMesh::emitRun(const ChainDrawBatch& batch, const Run& run, Color body, Color glow) {
+    const std::span<const JointDraw> joints = batch.Chain(run.chain);
+    const int n = static_cast<int>(joints.size());
+    const int count = run.last - run.first + 1;
+    // The body strip, then the glow strip over it.
+    const StripMesh::Strips room = strips.Add(2, count);
+    float* bodyVertices = room.vertices;
+    float* glowVertices = bodyVertices + count * 6;
+    unsigned char* bodyColors = room.colors;
+    unsigned char* glowColors = bodyColors + count * 8;
+    // Neighbours come from the whole chain, so a strip split at the core
+    // shares its end vertices with the next one.
+    Vector2 out =
+        run.first > 0 ? StripDirection(joints[run.first - 1].pos, joints[run.first].pos) : Vector2{0.0f, 0.0f};
+    for (int i = run.first; i <= run.last; ++i) {
+        const Vector2 p = joints[i].pos;
+        const Vector2 in = out;
+        out = i + 1 < n ? StripDirection(p, joints[i + 1].pos) : Vector2{0.0f, 0.0f};
+        const Vector2 normal = MiterOffset(in, out, joints[i].width * 0.5f);
+
+        const auto put = [&](float*& vertices, unsigned char*& colors, float scale, Color color) {
+            vertices[0] = p.x + normal.x * scale;
+            vertices[1] = p.y + normal.y * scale;
+            vertices[2] = 0.0f;
+            vertices[3] = p.x - normal.x * scale;
+            vertices[4] = p.y - normal.y * scale;
+            vertices[5] = 0.0f;
+            vertices += 6;
+            const unsigned char a = Alpha(color, joints[i].depthAlpha);
+            for (int side = 0; side < 2; ++side) {
+                colors[0] = color.r;
+                colors[1] = color.g;
+                colors[2] = color.b;
+                colors[3] = a;
+                colors += 4;
+            }
+        };
+        put(bodyVertices, bodyColors, 1.0f, body);
+        put(glowVertices, glowColors, 0.6f, glow);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "strip_mesh.hpp"
+#include "tentacle_bank.hpp"
+
+#include <raylib.h>
+
+#include <vector>
+
+// Draws the tentacles as triangle strips: every chain becomes one mitered,
+// tapered strip for its body and a narrower one for its glow, with the depth
+// fade in the vertex colours, so joints have no gaps and overlap nothing.
+// A chain is split where it passes through the core's plane, so the core can
+// be drawn between the strips behind it and those in front.
+//
+// The strips go into a StripMesh, about 540 full-length tentacles per draw
+// call.
+class TentacleMesh {
+public:
+    // Builds and uploads this frame's strips. Vertex alpha is the colour's
+    // alpha times the joint's depth fade.
+    void Build(const ChainDrawBatch& batch, Color body, Color glow);
+    // Strips behind the core, back to front, then those in front of it.
+    void DrawBack() const;
+    void DrawFront() const;
+
+private:
+    // Joints first..last of one chain, all on one side of the core.
+    struct Run {
+        int chain;
+        int first;
+        int last;
+        float depth;
+    };
+
+    void addRuns(const ChainDrawBatch& batch, int chain);
+    void emitRun(const ChainDrawBatch& batch, const Run& run, Color body, Color glow);
+
+    std::vector<Run> backRuns;
+    std::vector<Run> frontRuns;
+    StripMesh strips;
+    int backChunks{0};
+};
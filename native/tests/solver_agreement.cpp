@@ -0,0 +1,229 @@
+// Steps identical tentacle banks on the scalar reference solver and on the
+// lane kernels of every instruction set this CPU supports, and fails if any
+// joint of any kernel build strays further than TOLERANCE from the reference.
+// Each configuration (constraint model, distance solver, species mix) runs
+// STEPS fixed steps with the core dragged around a circle and the wave
+// switching between idle and active, so every kernel path is exercised. The
+// resting configuration lets the core stop after the first third, so the
+// chains fall asleep and are held; it also fails if the held tips stop
+// swaying relative to their anchors. The particle kernels are checked the same
+// way: trail particles stepped on every build must match the scalar build,
+// and so must the prey hit test.
+
+#include "particle_kernels.hpp"
+#include "simulation.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+namespace {
+constexpr int STEPS = 600;
+constexpr float DT = 1.0f / 60.0f;
+constexpr int TENTACLES = 30;
+constexpr float ATTACH_RADIUS = 50.0f;
+// Greatest allowed distance, in px, between a kernel joint and the
+// reference. The kernels are built without FMA contraction and share the
+// reference's approximations, so they should agree to rounding.
+constexpr float TOLERANCE = 1e-3f;
+// Least mean tip movement, in px per step relative to the anchor, of a
+// sleeping chain; the idle wave keeps held chains swaying.
+constexpr double MIN_SWAY = 0.01;
+
+struct Config {
+    const char* name;
+    ConstraintModel model;
+    DistanceSolver distances;
+    bool species;
+    bool rest;
+};
+
+std::vector<TentacleGroup> Groups(bool species) {
+    if (!species) return {TentacleGroup{TentacleArchetype{}, TENTACLES}};
+    TentacleArchetype darter;
+    darter.segments = 16;
+    darter.segmentLength = 11.0f;
+    TentacleArchetype trailer;
+    trailer.segments = 40;
+    trailer.segmentLength = 8.0f;
+    return {{TentacleArchetype{}, 10}, {darter, 10}, {trailer, 10}};
+}
+
+struct Run {
+    TentacleBank bank;
+    Core core;
+    AnchorRing ring;
+    bool rest;
+    // Each tip in its anchor's frame at the last step, and the summed
+    // movement of the sleeping tips in that frame.
+    std::vector<Vector2> localTip;
+    double sway = 0.0;
+    int swaySteps = 0;
+
+    Run(const Config& config, SolverPath path, SimdIsa isa) : rest(config.rest) {
+        core.pos = {640.0f, 360.0f, 0.0f};
+        core.radius = ATTACH_RADIUS;
+        Pcg32 rng(1, 1);
+        bank.Init(core, Groups(config.species), ATTACH_RADIUS, rng);
+        bank.SetSolverPath(path);
+        bank.SetSimdIsa(isa);
+        bank.SetConstraintModel(config.model);
+        bank.SetDistanceSolver(config.distances);
+    }
+
+    void Step(int step) {
+        // The core circles the screen centre, pulling the chains about.
+        if (rest && step >= STEPS / 3) {
+            core.vx = 0.0f;
+            core.vy = 0.0f;
+            bank.Update(DT, static_cast<double>(step) * DT * 1000.0, false, ring, core);
+            return;
+        }
+        const float t = static_cast<float>(step) * DT;
+        const Vector3 next{640.0f + std::cos(t * 1.7f) * 120.0f, 360.0f + std::sin(t * 1.1f) * 90.0f, 0.0f};
+        core.vx = next.x - core.pos.x;
+        core.vy = next.y - core.pos.y;
+        core.pos = next;
+        const bool active = (step / 90) % 2 == 1;
+        bank.Update(DT, static_cast<double>(step) * DT * 1000.0, active, ring, core);
+    }
+
+    void MeasureSway() {
+        localTip.resize(bank.Count());
+        for (int t = 0; t < bank.Count(); ++t) {
+            const Vector3 tip = bank.Tip(t);
+            const float qx = tip.x - core.pos.x;
+            const float qy = tip.y - core.pos.y;
+            const float c = std::cos(bank.AnchorAngle(t));
+            const float s = std::sin(bank.AnchorAngle(t));
+            const Vector2 local{qx * c + qy * s, qy * c - qx * s};
+            if (bank.IsSleeping(t)) {
+                sway += std::hypot(local.x - localTip[t].x, local.y - localTip[t].y);
+                ++swaySteps;
+            }
+            localTip[t] = local;
+        }
+    }
+
+    double MeanSway() const { return swaySteps > 0 ? sway / swaySteps : 0.0; }
+};
+
+// Largest distance between matching joints of the two banks.
+float MaxDeviation(const TentacleBank& a, const TentacleBank& b) {
+    float worst = 0.0f;
+    for (int t = 0; t < a.Count(); ++t) {
+        if (a.SegmentsOf(t) != b.SegmentsOf(t)) return INFINITY;
+        for (int i = 0; i < a.SegmentsOf(t); ++i) {
+            const Vector3 p = a.Position(t, i);
+            const Vector3 q = b.Position(t, i);
+            const float dx = p.x - q.x;
+            const float dy = p.y - q.y;
+            const float dz = p.z - q.z;
+            worst = std::fmax(worst, std::sqrt(dx * dx + dy * dy + dz * dz));
+        }
+    }
+    return worst;
+}
+
+// Trail particles, stepped PARTICLE_STEPS times on one kernel build; the
+// count leaves a remainder for the F32x1 tail.
+constexpr std::size_t PARTICLES = 37;
+constexpr int PARTICLE_STEPS = 40;
+
+struct Trails {
+    AlignedVector<float> arrays[8];
+
+    Trails() {
+        Pcg32 rng(1, 2);
+        for (AlignedVector<float>& a : arrays) a.resize(PARTICLES);
+        for (std::size_t i = 0; i < PARTICLES; ++i) {
+            arrays[0][i] = rng.Range(0.0f, 1280.0f);
+            arrays[1][i] = rng.Range(0.0f, 720.0f);
+            arrays[2][i] = rng.Range(-15.0f, 15.0f);
+            arrays[3][i] = rng.Range(-15.0f, 15.0f);
+            arrays[4][i] = 0.8f;
+            arrays[5][i] = rng.Range(2.0f, 5.0f);
+            arrays[6][i] = 0.0f;
+            arrays[7][i] = rng.Range(0.3f, 0.7f);
+        }
+    }
+
+    void Step(const ParticleKernels& kernels) {
+        const TrailBlock block{arrays[0].data(), arrays[1].data(), arrays[2].data(), arrays[3].data(),
+                               arrays[4].data(), arrays[5].data(), arrays[6].data(), arrays[7].data(),
+                               PARTICLES, DT, 0.97f, 0.95f};
+        kernels.advanceTrails(block);
+    }
+};
+
+// Whether the trails and hit test of isa match the scalar build exactly.
+bool ParticlesAgree(SimdIsa isa) {
+    const ParticleKernels reference = ParticleKernelsFor(SimdIsa::Scalar);
+    const ParticleKernels kernels = ParticleKernelsFor(isa);
+    Trails a, b;
+    for (int step = 0; step < PARTICLE_STEPS; ++step) {
+        a.Step(reference);
+        b.Step(kernels);
+    }
+    for (int k = 0; k < 8; ++k) {
+        if (a.arrays[k] != b.arrays[k]) return false;
+    }
+    // Probe around the screen; each count exercises a different tail.
+    for (std::size_t count = 0; count <= PARTICLES; ++count) {
+        for (float cx = 0.0f; cx < 1280.0f; cx += 80.0f) {
+            for (float cy = 0.0f; cy < 720.0f; cy += 80.0f) {
+                const float* x = a.arrays[0].data();
+                const float* y = a.arrays[1].data();
+                const int want = reference.firstWithin(x, y, count, cx, cy, 60.0f);
+                if (kernels.firstWithin(x, y, count, cx, cy, 60.0f) != want) return false;
+            }
+        }
+    }
+    return true;
+}
+}
+
+int main() {
+    const Config configs[] = {
+        {"pbd gauss-seidel", ConstraintModel::Pbd, DistanceSolver::GaussSeidel, false, false},
+        {"pbd direct", ConstraintModel::Pbd, DistanceSolver::Direct, false, false},
+        {"xpbd gauss-seidel", ConstraintModel::Xpbd, DistanceSolver::GaussSeidel, false, false},
+        {"pbd species", ConstraintModel::Pbd, DistanceSolver::GaussSeidel, true, false},
+        {"pbd resting", ConstraintModel::Pbd, DistanceSolver::GaussSeidel, false, true},
+    };
+    const SimdIsa isas[] = {SimdIsa::Scalar, SimdIsa::Sse2, SimdIsa::Avx2, SimdIsa::Avx512};
+
+    int failures = 0;
+    for (const Config& config : configs) {
+        for (const SimdIsa isa : isas) {
+            if (!IsSimdIsaSupported(isa)) {
+                std::printf("%-18s %-7s skipped (not supported)\n", config.name, SimdIsaName(isa));
+                continue;
+            }
+            Run reference(config, SolverPath::Scalar, SimdIsa::Scalar);
+            Run kernels(config, SolverPath::Simd, isa);
+            float worst = 0.0f;
+            int slept = 0;
+            for (int step = 0; step < STEPS; ++step) {
+                reference.Step(step);
+                kernels.Step(step);
+                worst = std::fmax(worst, MaxDeviation(reference.bank, kernels.bank));
+                slept += kernels.bank.SleepingCount();
+                kernels.MeasureSway();
+            }
+            // A resting run that never sleeps would not test the held path.
+            const bool ok = worst <= TOLERANCE && (!config.rest || (slept > 0 && kernels.MeanSway() >= MIN_SWAY));
+            std::printf("%-18s %-7s max deviation %.3g px, %d tentacle steps asleep, tip sway %.3f px %s\n",
+                        config.name, SimdIsaName(isa), worst, slept, kernels.MeanSway(), ok ? "ok" : "FAILED");
+            if (!ok) ++failures;
+        }
+    }
+    for (const SimdIsa isa : isas) {
+        if (!IsSimdIsaSupported(isa)) continue;
+        const bool ok = ParticlesAgree(isa);
+        std::printf("%-18s %-7s %s\n", "particles", SimdIsaName(isa), ok ? "ok" : "FAILED");
+        if (!ok) ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}